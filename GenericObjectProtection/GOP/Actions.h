@@ -19,33 +19,53 @@
 #ifndef __ACTIONS_H__
 #define __ACTIONS_H__
 
+#include "GOP_GlobalConfig.h"
 #include "ObjectSize.h"
 
 namespace CoolChecksum {
 
 
+// OUT-OF-LINE CHECKSUM FUNCTIONS (one instance per class, shared by all derived classes)
+template<typename T>
+struct __Outlined {
+#if GOP_OUTLINE_CHECKSUM_FUNCTIONS
+  static bool __check(T *c) __attribute__((noinline)) { return T::__chksum_t::__check(c); }
+  static void __generate(T *c) __attribute__((noinline)) { T::__chksum_t::__generate(c); }
+#else
+  __attribute__((always_inline)) static inline bool __check(T *c) { return T::__chksum_t::__check(c); }
+  __attribute__((always_inline)) static inline void __generate(T *c) { T::__chksum_t::__generate(c); }
+#endif
+};
+
+
 // CONDITIONAL FUNCTIONS
 template<typename T, int hasCheckFct=__hasChecksumFunctions<T>::RET>
 struct __ConditionalCall { // only used if <T> __hasChecksumFunctions (sliced)
   __attribute__((always_inline)) static inline bool __check(T *c) {
-    return T::__chksum_t::__check(c);
+    return __Outlined<T>::__check(c);
   }
   __attribute__((always_inline)) static inline void __generate(T *c) {
-    T::__chksum_t::__generate(c);
+    __Outlined<T>::__generate(c);
   }
   __attribute__((always_inline)) static inline void __generate_mutable(T *c) {
     if(T::MEMBERS_MUTABLE != 0) {
-      T::__chksum_t::__generate(c);
+      __Outlined<T>::__generate(c);
     }
   }
   __attribute__((always_inline)) static inline void __generate_non_mutable(T *c) {
     if(T::MEMBERS_MUTABLE == 0) {
-      T::__chksum_t::__generate(c);
+      __Outlined<T>::__generate(c);
     }
   }
   __attribute__((always_inline)) static inline void __dirty(T *c) {
     c->__chksum.__dirty();
   }
+  __attribute__((always_inline)) static inline bool __is_dirty(T *c) {
+    return (c->__chksum.get_dirty() != 0);
+  }
+  __attribute__((always_inline)) static inline void __zero_padding(T *c) {
+    T::__chksum_t::__zero_padding(c);
+  }
   __attribute__((always_inline)) static inline void __static_dirty() {
     T::__static_chksum.__dirty();
   }
@@ -64,6 +84,18 @@ struct __ConditionalCall { // only used if <T> __hasChecksumFunctions (sliced)
   __attribute__((always_inline)) static inline bool __is_unlocked(T *c) {
     return c->__locker.__is_unlocked();
   }
+  __attribute__((always_inline)) static inline bool __enter_lock(T *c) {
+    return c->__locker.__enter_lock();
+  }
+  __attribute__((always_inline)) static inline void __verified(T *c) {
+    c->__locker.__verified();
+  }
+  __attribute__((always_inline)) static inline bool __leave_unlock(T *c) {
+    return c->__locker.__leave_unlock();
+  }
+  __attribute__((always_inline)) static inline const void* __locker_id(T *c) {
+    return &(c->__locker);
+  }
   __attribute__((always_inline)) static inline void __static_lock() { T::__static_lock(); }
   __attribute__((always_inline)) static inline void __static_construction_lock() {
     T::__static_lock();
@@ -78,6 +110,8 @@ struct __ConditionalCall<T,0> { // used if <T> has no ChecksumFunctions
   __attribute__((always_inline)) static inline void __generate_mutable(T *c) {}
   __attribute__((always_inline)) static inline void __generate_non_mutable(T *c) {}
   __attribute__((always_inline)) static inline void __dirty(T *c) {}
+  __attribute__((always_inline)) static inline bool __is_dirty(T *c) { return false; }
+  __attribute__((always_inline)) static inline void __zero_padding(T *c) {}
   __attribute__((always_inline)) static inline void __static_dirty() {}
   __attribute__((always_inline)) static inline void __static_check() {}
   __attribute__((always_inline)) static inline void __static_check_get() {}
@@ -86,6 +120,10 @@ struct __ConditionalCall<T,0> { // used if <T> has no ChecksumFunctions
   __attribute__((always_inline)) static inline void __unlock(T *c) {}
   __attribute__((always_inline)) static inline bool __is_locked(T *c) { return true; }
   __attribute__((always_inline)) static inline bool __is_unlocked(T *c) { return false; }
+  __attribute__((always_inline)) static inline bool __enter_lock(T *c) { return false; }
+  __attribute__((always_inline)) static inline void __verified(T *c) {}
+  __attribute__((always_inline)) static inline bool __leave_unlock(T *c) { return false; }
+  __attribute__((always_inline)) static inline const void* __locker_id(T *c) { return 0; }
   __attribute__((always_inline)) static inline void __static_lock() {}
   __attribute__((always_inline)) static inline void __static_construction_lock() {}
   __attribute__((always_inline)) static inline void __static_init_and_lock() {}
@@ -130,6 +168,15 @@ struct Dirty {
   }
 };
 
+template<typename TypeInfo, typename>
+struct IsDirty {
+  __attribute__((always_inline)) static void exec(typename TypeInfo::That* obj, bool* result) {
+    if(*result == false) {
+      *result = __ConditionalCall<typename TypeInfo::That>::__is_dirty(obj);
+    }
+  }
+};
+
 
 // Base class locking iteration. Stop when the first existing locker is found (per-object)
 // SFINAE check, whether a class T has a ready-to-use locker
@@ -215,6 +262,71 @@ struct IsUnLocked<TypeInfo, void> {
   };
 };
 
+template<typename TypeInfo, typename LAST>
+struct EnterLock {
+  typedef LockCalculator<TypeInfo, LAST> EXEC; // static context (compile-time calculation)
+  __attribute__((always_inline)) static void exec(typename TypeInfo::That* obj, bool* result) {
+    if(EXEC::USE_THIS_LOCKER) {
+      *result =
+        __ConditionalCall<typename TypeInfo::That, (EXEC::USE_THIS_LOCKER ? 1 : 0)>::__enter_lock(obj);
+    }
+  }
+};
+template<typename TypeInfo>
+struct EnterLock<TypeInfo, void> {
+  struct EXEC { // initial EXEC
+    static const bool LOCKER_FOUND = false;
+  };
+};
+
+template<typename TypeInfo, typename LAST>
+struct Verified {
+  typedef LockCalculator<TypeInfo, LAST> EXEC; // static context (compile-time calculation)
+  __attribute__((always_inline)) static void exec(typename TypeInfo::That* obj) {
+    __ConditionalCall<typename TypeInfo::That, (EXEC::USE_THIS_LOCKER ? 1 : 0)>::__verified(obj);
+  }
+};
+template<typename TypeInfo>
+struct Verified<TypeInfo, void> {
+  struct EXEC { // initial EXEC
+    static const bool LOCKER_FOUND = false;
+  };
+};
+
+template<typename TypeInfo, typename LAST>
+struct LeaveUnlock {
+  typedef LockCalculator<TypeInfo, LAST> EXEC; // static context (compile-time calculation)
+  __attribute__((always_inline)) static void exec(typename TypeInfo::That* obj, bool* result) {
+    if(EXEC::USE_THIS_LOCKER) {
+      *result =
+        __ConditionalCall<typename TypeInfo::That, (EXEC::USE_THIS_LOCKER ? 1 : 0)>::__leave_unlock(obj);
+    }
+  }
+};
+template<typename TypeInfo>
+struct LeaveUnlock<TypeInfo, void> {
+  struct EXEC { // initial EXEC
+    static const bool LOCKER_FOUND = false;
+  };
+};
+
+template<typename TypeInfo, typename LAST>
+struct LockerId {
+  typedef LockCalculator<TypeInfo, LAST> EXEC; // static context (compile-time calculation)
+  __attribute__((always_inline)) static void exec(typename TypeInfo::That* obj, const void** result) {
+    if(EXEC::USE_THIS_LOCKER) {
+      *result =
+        __ConditionalCall<typename TypeInfo::That, (EXEC::USE_THIS_LOCKER ? 1 : 0)>::__locker_id(obj);
+    }
+  }
+};
+template<typename TypeInfo>
+struct LockerId<TypeInfo, void> {
+  struct EXEC { // initial EXEC
+    static const bool LOCKER_FOUND = false;
+  };
+};
+
 
 // action types concerning the static checksum
 
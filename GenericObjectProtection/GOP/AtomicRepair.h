@@ -0,0 +1,124 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __ATOMIC_REPAIR_H__
+#define __ATOMIC_REPAIR_H__
+
+// Lock-free in-place repair of word-sized members:
+// The correct value (taken from a replica) is written by a single compare-and-swap
+// against the faulty value that has been observed while locating the error.
+// Thus, neither a concurrent writer nor a concurrent repairer is ever overwritten,
+// and the StopPreemption lock is needed for multi-word (or misaligned) members, only.
+
+#include "ObjectSize.h"
+
+namespace CoolChecksum {
+
+// the machine word to repair a member of SIZE bytes with
+template<unsigned SIZE> struct AtomicWord { enum { LOCK_FREE = 0 }; typedef void Type; };
+template<> struct AtomicWord<1> { enum { LOCK_FREE = 1 }; typedef unsigned char Type; };
+template<> struct AtomicWord<2> { enum { LOCK_FREE = 1 }; typedef unsigned short Type; };
+template<> struct AtomicWord<4> { enum { LOCK_FREE = 1 }; typedef unsigned int Type; };
+template<> struct AtomicWord<8> { enum { LOCK_FREE = (sizeof(void*) >= 8) }; typedef unsigned long long Type; };
+
+// context and outcome of a lock-free repair attempt
+template<typename Flags>
+struct AtomicRepairState {
+  const Flags* flags; // dirty/version flags of the object being repaired
+  const unsigned long long sequence; // the replicas' version we vote on
+  bool needs_lock; // a faulty member cannot be repaired lock-free (or all replicas differ)
+  bool aborted; // the object has been modified concurrently: nothing to repair
+  bool corrected; // at least one member has been repaired
+  AtomicRepairState(const Flags* f, unsigned long long s) : flags(f), sequence(s), needs_lock(false), aborted(false), corrected(false) {}
+};
+
+template<unsigned SIZE, bool tLOCK_FREE=AtomicWord<SIZE>::LOCK_FREE>
+struct AtomicRepair {
+  enum { LOCK_FREE = 1 };
+  typedef typename AtomicWord<SIZE>::Type W;
+
+  __attribute__((always_inline)) inline static W load(const void* data) {
+    W value;
+    __builtin_memcpy(&value, data, SIZE);
+    return value;
+  }
+
+  // Repair 'member' from the replicas 'copy1' and 'copy2' (majority vote).
+  // DMR variants pass the same replica twice.
+  template<typename State>
+  __attribute__((always_inline)) inline static void exec(void* member, const void* copy1, const void* copy2, State* state) {
+    if(state->aborted) {
+      return;
+    }
+    if( ((unsigned long) member % sizeof(W)) != 0 ) {
+      // misaligned (e.g., packed) member: no atomic access possible
+      AtomicRepair<SIZE, false>::exec(member, copy1, copy2, state);
+      return;
+    }
+    W observed = __atomic_load_n((W*) member, __ATOMIC_RELAXED); // the (possibly faulty) value we vote on
+    const W correct = load(copy1);
+    if(observed == correct) {
+      return; // fine (or fixed already by someone else)
+    }
+    if(correct != load(copy2)) {
+      if(observed != load(copy2)) {
+        state->needs_lock = true; // all three copies differ -> let the locked path decide
+      }
+      return; // otherwise, copy1 is faulty: will be overwritten on next non-const function
+    }
+    // the observed value must not stem from a concurrent writer
+    if(state->flags->is_valid(state->sequence) == false) {
+      state->aborted = true;
+      return;
+    }
+    if(__atomic_compare_exchange_n((W*) member, &observed, correct, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+      state->corrected = true;
+    }
+    // else: modified in the meantime (concurrent writer or repairer): leave it as it is
+  }
+};
+
+// members that are not word-sized: the StopPreemption lock is required
+template<unsigned SIZE>
+struct AtomicRepair<SIZE, false> {
+  enum { LOCK_FREE = 0 };
+
+  template<typename State>
+  __attribute__((always_inline)) inline static void exec(void* member, const void* copy1, const void* copy2, State* state) {
+    if( (__builtin_memcmp(member, copy1, SIZE) != 0) && (__builtin_memcmp(member, copy2, SIZE) != 0) ) {
+      state->needs_lock = true;
+    }
+  }
+};
+
+// compile-time: number of checksummed members that can be repaired lock-free
+template<typename MemberInfo, typename LAST>
+struct AtomicRepairable {
+  struct EXEC {
+    enum { STATIC = LAST::STATIC,
+           WORDS = LAST::WORDS + (AtomicRepair<SizeOfChecksummed<MemberInfo, STATIC>::SIZE>::LOCK_FREE ? 1 : 0) };
+  };
+};
+template<bool tSTATIC>
+struct AtomicRepairableInit {
+  enum { STATIC = tSTATIC, WORDS = 0 };
+};
+
+} //CoolChecksum
+
+#endif /* __ATOMIC_REPAIR_H__ */
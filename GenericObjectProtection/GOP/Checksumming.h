@@ -65,7 +65,7 @@ namespace CoolChecksum {
   template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
   // once again, puma is not willing to accept this ... :-(
   #ifndef __puma
-  JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE,
+  MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE,
   #else
   0,
   #endif
@@ -91,6 +91,8 @@ class Checksumming {
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(...) { return true; }
   __attribute__((always_inline)) inline static void __generate(...) {}
+  __attribute__((always_inline)) inline static void __update(...) {}
+  __attribute__((always_inline)) inline static void __commit(...) {}
   __attribute__((always_inline)) inline void __dirty() const {}
 };
 } //CoolChecksum
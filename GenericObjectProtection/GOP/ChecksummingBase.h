@@ -19,7 +19,10 @@
 #ifndef __CHECKSUMMING_BASE_H__
 #define __CHECKSUMMING_BASE_H__
 
+#include "GOP_GlobalConfig.h"
 #include "MemoryBarriers.h"
+#include "ThreadToken.h"
+#include "WholeObject.h"
 
 
 namespace CoolChecksum {
@@ -27,6 +30,85 @@ namespace CoolChecksum {
 // Base class for all "Checksumming_*" classes that provides flags for
 // soft (non-blocking) synchronization
 
+#if GOP_USE_SEQLOCK_FLAGS
+
+template<typename TypeInfo, bool STATIC, unsigned SYNCHRONIZED=
+  (TypeInfo::That::SYNCHRONIZED == 1) ? 1 : ((STATIC == true) ? TypeInfo::That::INHERITANCE : 0)> // 1 or 0
+  // classes with inheritance relations get always a static locker for efficiency (see LockAdviceInvoker.ah)
+class ChecksummingBase {
+private:
+  // seqlock-style flags for soft synchronization, packed into a single 64-bit word:
+  // bits 63..32: version, bits 31..1: the writer's thread id, bit 0: dirty
+  // (intended for 64-bit targets, where plain 64-bit loads are atomic)
+  mutable unsigned long long seqlock;
+
+  enum { VERSION_SHIFT = 32 };
+  static const unsigned long long WRITER_MASK = 0xFFFFFFFFULL; // dirty bit and thread id
+
+  // the thread's id with the dirty bit set. Not the (truncated) thread_token(): two threads
+  // whose tokens agree in the remaining bits could reset each other's dirty flag.
+  __attribute__((always_inline)) inline static unsigned long long writer() {
+    return (((unsigned long long) thread_number<31>()) << 1) | 1;
+  }
+
+  __attribute__((always_inline)) inline unsigned long long load() const {
+    barrier();
+    const unsigned long long reg_seqlock = seqlock;
+    barrier();
+    return reg_seqlock;
+  }
+
+protected:
+  // increments the version and resets the dirty flag with a single CAS
+  __attribute__((always_inline)) inline void reset_dirty() {
+    const unsigned long long reg_seqlock = load();
+    if((reg_seqlock & WRITER_MASK) == writer()) { // compare to my thread's id
+      __sync_bool_compare_and_swap(&seqlock, reg_seqlock,
+                                   ((reg_seqlock >> VERSION_SHIFT) + 1) << VERSION_SHIFT);
+    }
+    // the __sync routines provide a memory barrier (implicitly)
+  }
+
+  __attribute__((always_inline)) inline unsigned int get_version() const {
+    return (unsigned int) (load() >> VERSION_SHIFT);
+  }
+
+  __attribute__((always_inline)) inline void inc_version() {} // see reset_dirty()
+
+public:
+  // used in LockAdviceInvoker
+  __attribute__((always_inline)) inline void __dirty() const {
+    // a CAS instead of a plain store: a concurrent reset_dirty() must not be undone,
+    // otherwise an already used version could show up again.
+    unsigned long long reg_seqlock = load();
+    unsigned long long prev;
+    while((prev = __sync_val_compare_and_swap(&seqlock, reg_seqlock,
+                                              (reg_seqlock & ~WRITER_MASK) | writer())) != reg_seqlock) {
+      reg_seqlock = prev;
+    }
+  }
+
+  __attribute__((always_inline)) inline const void* const get_dirty() const {
+    return (const void*)(unsigned long) (load() & WRITER_MASK);
+  }
+
+  // remember which checksum we're verifying, and test later whether it is still valid:
+  // a single load and compare
+  __attribute__((always_inline)) inline unsigned long long get_sequence() const {
+    return load();
+  }
+  __attribute__((always_inline)) inline bool is_valid(const unsigned long long sequence) const {
+    return ((sequence & WRITER_MASK) == 0) && (sequence == load());
+  }
+
+  // used in ChecksumAdviceInvoker after construction (GOP_USE_WHOLE_OBJECT_CHECKSUM)
+  __attribute__((always_inline)) inline static void __zero_padding(typename TypeInfo::That* obj) {
+    WholeObject<TypeInfo, STATIC>::zero_padding(obj);
+  }
+};
+
+#else /* ! GOP_USE_SEQLOCK_FLAGS */
+
 template<typename TypeInfo, bool STATIC, unsigned SYNCHRONIZED=
   (TypeInfo::That::SYNCHRONIZED == 1) ? 1 : ((STATIC == true) ? TypeInfo::That::INHERITANCE : 0)> // 1 or 0
   // classes with inheritance relations get always a static locker for efficiency (see LockAdviceInvoker.ah)
@@ -43,7 +125,7 @@ private:
   // will always reload the accessed variables.
 protected:
   __attribute__((always_inline)) inline void reset_dirty() {
-    __sync_bool_compare_and_swap(&dirty, __builtin_frame_address(0), 0); // compare to my thread's id
+    __sync_bool_compare_and_swap(&dirty, (void*) thread_token(), 0); // compare to my thread's id
     // the __sync routines provide a memory barrier (implicitly)
   }
 
@@ -64,7 +146,7 @@ public:
   // used in LockAdviceInvoker
   __attribute__((always_inline)) inline void __dirty() const {
     barrier();
-    dirty = __builtin_frame_address(0); // set to: my thread's id
+    dirty = (void*) thread_token(); // set to: my thread's id
     barrier();
   }
 
@@ -74,8 +156,23 @@ public:
     barrier();
     return reg_dirty;
   }
+
+  // remember which checksum we're verifying, and test later whether it is still valid
+  __attribute__((always_inline)) inline unsigned long long get_sequence() const {
+    return get_version();
+  }
+  __attribute__((always_inline)) inline bool is_valid(const unsigned long long sequence) const {
+    return (get_dirty() == 0) && (sequence == get_version());
+  }
+
+  // used in ChecksumAdviceInvoker after construction (GOP_USE_WHOLE_OBJECT_CHECKSUM)
+  __attribute__((always_inline)) inline static void __zero_padding(typename TypeInfo::That* obj) {
+    WholeObject<TypeInfo, STATIC>::zero_padding(obj);
+  }
 };
 
+#endif /* GOP_USE_SEQLOCK_FLAGS */
+
 
 template<typename TypeInfo, bool STATIC>
 class ChecksummingBase<TypeInfo, STATIC, 0> { // Empty class, providing no flags at all
@@ -87,6 +184,11 @@ protected:
 public:
   __attribute__((always_inline)) inline void __dirty() const {}
   __attribute__((always_inline)) inline const void* const get_dirty() const { return 0; }
+  __attribute__((always_inline)) inline unsigned long long get_sequence() const { return 0; }
+  __attribute__((always_inline)) inline bool is_valid(const unsigned long long sequence) const { return true; }
+  __attribute__((always_inline)) inline static void __zero_padding(typename TypeInfo::That* obj) {
+    WholeObject<TypeInfo, STATIC>::zero_padding(obj);
+  }
 };
 
 
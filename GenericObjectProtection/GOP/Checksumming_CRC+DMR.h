@@ -57,7 +57,7 @@ struct CopyAndCRC {
 template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
 // once again, puma is not willing to accept this ... :-(
 #ifndef __puma
-JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
+MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
 #else
 0
 #endif
@@ -86,9 +86,9 @@ class ChecksummingCRCDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(T* obj, U* checksum) {
     if(self(obj).get_dirty() == 0) {
-      const unsigned int version = self(obj).get_version();
+      const unsigned long long sequence = self(obj).get_sequence();
       *checksum = self(obj).crc32;
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         return true; // checksum valid
       }
     }
@@ -96,13 +96,16 @@ class ChecksummingCRCDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
   }
 
   __attribute__((always_inline)) inline static bool __check(T* obj) {
-    const unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
+    if(self(obj).is_valid(sequence) == false) {
+      return true; // being modified concurrently (dirty): nothing to verify
+    }
     unsigned int crc32_tmp = 0xFFFFFFFF;
-    JPTL::MemberIterator<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp);
+    MemberTraversal<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp);
     if(self(obj).crc32 != crc32_tmp) {
       // checksum error ... now let's find the cause
       // test whether we had not been interrupted while verifying the checksum
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         // okay, we found bit errors ... so let's repair
         return __repair(obj);
       }
@@ -113,11 +116,15 @@ class ChecksummingCRCDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
   __attribute__((always_inline)) inline static void __generate(T* obj) {
     // dirty has to be set to *before* this function is entered (and before the locker is unlocked), see: LockAdviceInvoker.ah
     unsigned int crc32_tmp = 0xFFFFFFFF; // calculate crc32, and store intermediate results on our own stack
-    JPTL::MemberIterator<TypeInfo, CopyAndCRC, DMRInit<STATIC> >::exec(obj, &crc32_tmp, getShadowAttribs(obj));
+    MemberTraversal<TypeInfo, CopyAndCRC, DMRInit<STATIC> >::exec(obj, &crc32_tmp, getShadowAttribs(obj));
     self(obj).crc32 = crc32_tmp; // finally, update the object's crc32 by a single copy instruction
     self(obj).inc_version(); // increment version counter
     self(obj).reset_dirty();
   }
+
+  // no incremental update (see Checksumming_SUM+DMR.h): __commit() re-generates the CRC
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(T* obj) { __generate(obj); }
   
   // ctor for static checksum, only: initialization on startup, before "main"
   ChecksummingCRCDMR() {
@@ -130,18 +137,37 @@ class ChecksummingCRCDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
 
 template<typename TypeInfo, bool STATIC, unsigned tSIZE>
 bool ChecksummingCRCDMR<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
+  // first, try to repair word-sized members lock-free
+  if(MemberTraversal<TypeInfo, AtomicRepairable, AtomicRepairableInit<STATIC> >::EXEC::WORDS != 0) {
+    AtomicRepairState<ChecksummingCRCDMR> state(&self(obj), self(obj).get_sequence());
+    const unsigned int crc32_shadow = CRC<SIZE>::gen(0xFFFFFFFF, getShadowAttribs(obj));
+    const bool object_faulty = (crc32_shadow == self(obj).crc32); // shadow copy and checksum agree
+    if(self(obj).is_valid(state.sequence) == false) {
+      return true; // dirty bit set ... fine, object already in use
+    }
+    if(object_faulty) {
+      MemberTraversal<TypeInfo, CopyRepairAtomic, DMRInit<STATIC> >::exec(obj, getShadowAttribs(obj), &state);
+      if(state.corrected) {
+        errorCorrected();
+      }
+      if(state.needs_lock == false) {
+        return true; // repaired, or modified concurrently
+      }
+    }
+  }
+
   // stop preemption from now (FIXME: only for T::SYNCHRONIZED==1)
-  StopPreemption stop; // constructor/destructor pattern
+  StopPreemption stop(&self(obj)); // constructor/destructor pattern, one lock per address stripe
 
   // The detected error could have been fixed by another thread,
   // while we had been waiting for the StopPreemption lock
   // Thus, check again ...
   if(self(obj).get_dirty() == 0) {
     // checksum is still valid (not dirty)
-    unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
     unsigned int crc32_tmp = 0xFFFFFFFF;
-    JPTL::MemberIterator<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp); //TODO: don't unroll (rare case)
-    if( (self(obj).crc32 == crc32_tmp) || (self(obj).get_dirty() != 0) || (version != self(obj).get_version()) ) {
+    MemberTraversal<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp); //TODO: don't unroll (rare case)
+    if( (self(obj).crc32 == crc32_tmp) || (self(obj).is_valid(sequence) == false) ) {
       return true; // this error has been fixed already by someone else
     }
     //return false; // for DEBUG only: catch false-positives
@@ -151,7 +177,7 @@ bool ChecksummingCRCDMR<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
     if(crc32_shadow == self(obj).crc32) {
       // real object is faulty!
       self(obj).crc32 = ~crc32_shadow; // ensure the checksum won't match (while repairing)
-      JPTL::MemberIterator<TypeInfo, CopyRepair, DMRInit<STATIC> >::exec(obj, getShadowAttribs(obj));
+      MemberTraversal<TypeInfo, CopyRepair, DMRInit<STATIC> >::exec(obj, getShadowAttribs(obj));
       self(obj).crc32 = crc32_shadow; // restore proper checksum
       errorCorrected();
     }
@@ -176,6 +202,8 @@ class ChecksummingCRCDMR<TypeInfo, STATIC, 0> : public ChecksummingBase<TypeInfo
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(typename TypeInfo::That* obj) { return true; }
   __attribute__((always_inline)) inline static void __generate(typename TypeInfo::That* obj) {}
+  __attribute__((always_inline)) inline static void __update(typename TypeInfo::That* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(typename TypeInfo::That* obj) {}
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(typename TypeInfo::That* obj, U* checksum) { *checksum = 0; return true; }
 };
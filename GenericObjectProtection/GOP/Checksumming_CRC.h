@@ -162,7 +162,7 @@ struct CRCOnly {
 template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
 // once again, puma is not willing to accept this ... :-(
 #ifndef __puma
-JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
+MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
 #else
 0
 #endif
@@ -183,9 +183,9 @@ class ChecksummingCRC : public ChecksummingBase<TypeInfo, STATIC> { // Checksumm
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(T* obj, U* checksum) {
     if(self(obj).get_dirty() == 0) {
-      const unsigned int version = self(obj).get_version();
+      const unsigned long long sequence = self(obj).get_sequence();
       *checksum = self(obj).crc32;
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         return true; // checksum valid
       }
     }
@@ -193,13 +193,16 @@ class ChecksummingCRC : public ChecksummingBase<TypeInfo, STATIC> { // Checksumm
   }
 
   __attribute__((always_inline)) inline static bool __check(T* obj) {
-    const unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
+    if(self(obj).is_valid(sequence) == false) {
+      return true; // being modified concurrently (dirty): nothing to verify
+    }
     unsigned int crc32_tmp = 0xFFFFFFFF;
-    JPTL::MemberIterator<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp);
+    MemberTraversal<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp);
     if(self(obj).crc32 != crc32_tmp) {
       // checksum error ... now let's find the cause
       // test whether we had not been interrupted while verifying the checksum
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         return false; // real checksum error ... return "detected"
       }
     }
@@ -216,11 +219,15 @@ class ChecksummingCRC : public ChecksummingBase<TypeInfo, STATIC> { // Checksumm
     // see: https://www.fpcomplete.com/user/edwardk/parallel-crc
 
     unsigned int crc32_tmp = 0xFFFFFFFF; // calculate crc32, and store intermediate results on our own stack
-    JPTL::MemberIterator<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp);
+    MemberTraversal<TypeInfo, CRCOnly, DMRInit<STATIC> >::exec(obj, &crc32_tmp);
     self(obj).crc32 = crc32_tmp; // finally, update the object's crc32 by a single copy instruction
     self(obj).inc_version(); // increment version counter
     self(obj).reset_dirty();
   }
+
+  // no incremental update (see Checksumming_SUM+DMR.h): __commit() re-generates the CRC
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(T* obj) { __generate(obj); }
   
   // ctor for static checksum, only: initialization on startup, before "main"
   ChecksummingCRC() {
@@ -239,6 +246,8 @@ class ChecksummingCRC<TypeInfo, STATIC, 0> : public ChecksummingBase<TypeInfo, S
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(typename TypeInfo::That* obj) { return true; }
   __attribute__((always_inline)) inline static void __generate(typename TypeInfo::That* obj) {}
+  __attribute__((always_inline)) inline static void __update(typename TypeInfo::That* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(typename TypeInfo::That* obj) {}
   template<typename U>
   __attribute__((always_inline)) inline static unsigned int getChecksum(typename TypeInfo::That* obj, U* checksum) { *checksum = 0; return true; }
 };
@@ -23,6 +23,7 @@
 #include "ObjectSize.h"
 #include "JPTL.h"
 #include "StopPreemption.h"
+#include "AtomicRepair.h"
 
 #include <inttypes.h>
 
@@ -129,6 +130,10 @@ struct MemberAccess {
   __attribute__((always_inline)) static inline void writeValue(void* member, const T value) {
     __builtin_memcpy(member, &value, SIZE); // set #SIZE bytes
   }
+
+  __attribute__((always_inline)) static inline void flipBits(void* member, const T bits) {
+    writeValue(member, readValue(member) ^ bits);
+  }
 };
 // read and write an integer-sized value from and to a (part of) a member's memory
 template<typename T>
@@ -141,6 +146,17 @@ struct TypedMemberAccess {
   __attribute__((always_inline)) static inline void writeValue(void* member, const T value) {
     *static_cast<T*>(member) = value;
   }
+
+  // a single compare-and-swap against the observed (faulty) value:
+  // a concurrent writer is never overwritten by the repair (see AtomicRepair.h)
+  __attribute__((always_inline)) static inline void flipBits(void* member, T bits) {
+    T observed = readValue(member);
+    if( (AtomicWord<sizeof(T)>::LOCK_FREE == 0) || (((unsigned long) member % sizeof(T)) != 0) ) {
+      writeValue(member, observed ^ bits); // misaligned: no atomic access possible
+      return;
+    }
+    __atomic_compare_exchange_n(static_cast<T*>(member), &observed, observed ^ bits, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+  }
 };
 // specializations for integer-sized memory accesses
 template<typename T>
@@ -232,9 +248,7 @@ public:
   __attribute__((always_inline)) static inline void repair(void* member, const unsigned int syndrome, const T bitpos) {
     if(syndrome == PARITY_MATRIX_COLUMN) {
       // error found, fix it:
-      typename MemberAccess<T, SIZE>::Type value = MemberAccess<T, SIZE>::readValue(member);
-      value ^= static_cast<typename MemberAccess<T, SIZE>::Type>(bitpos);
-      MemberAccess<T, SIZE>::writeValue(member, value);
+      MemberAccess<T, SIZE>::flipBits(member, static_cast<typename MemberAccess<T, SIZE>::Type>(bitpos));
     }
   }
 };
@@ -265,9 +279,7 @@ void array_repair(void* member, const unsigned int syndrome, const T bitpos,
   for(; loops > 0; --loops) {
     if(syndrome == v) {
       // error found, fix it:
-      typename MemberAccess<T, sizeof(machine_word_t)>::Type value = MemberAccess<T, sizeof(machine_word_t)>::readValue(member);
-      value ^= static_cast<typename MemberAccess<T, sizeof(machine_word_t)>::Type>(bitpos);
-      MemberAccess<T, sizeof(machine_word_t)>::writeValue(member, value);
+      MemberAccess<T, sizeof(machine_word_t)>::flipBits(member, static_cast<typename MemberAccess<T, sizeof(machine_word_t)>::Type>(bitpos));
       return; // we're finished here, only one syndrome can match
     }
     member = (void*) (((char*)member) + sizeof(machine_word_t)); // next word
@@ -490,7 +502,7 @@ struct ClearHammigArray<DIM, 0> {
 template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
 // once again, puma is not willing to accept this ... :-(
 #ifndef __puma
-JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
+MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
 #else
 0
 #endif
@@ -501,7 +513,7 @@ class ChecksummingHamming : public ChecksummingBase<TypeInfo, STATIC> { // Check
   typedef typename TypeInfo::That T;
 
   // number of word-sized fields to protect
-  static const unsigned int WORDS = JPTL::MemberIterator<TypeInfo, HammingCodeInfo, HammingCodeInfoInit<STATIC, 2> >::EXEC::WORDS;
+  static const unsigned int WORDS = MemberTraversal<TypeInfo, HammingCodeInfo, HammingCodeInfoInit<STATIC, 2> >::EXEC::WORDS;
   // the above template parameter (DIMENSION) is set to 1, as we don't know the DIMENSION right here
   static const unsigned int DIMENSION = RequiredRedundancy<WORDS>::RESULT; // in WORDS
   
@@ -520,9 +532,9 @@ class ChecksummingHamming : public ChecksummingBase<TypeInfo, STATIC> { // Check
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(T* obj, U* checksum) {
     if(self(obj).get_dirty() == 0) {
-      const unsigned int version = self(obj).get_version();
+      const unsigned long long sequence = self(obj).get_sequence();
       *checksum = self(obj).parity;
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         return true; // checksum valid
       }
     }
@@ -530,13 +542,16 @@ class ChecksummingHamming : public ChecksummingBase<TypeInfo, STATIC> { // Check
   }
 
   __attribute__((always_inline)) inline static bool __check(T* obj) {
-    const unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
+    if(self(obj).is_valid(sequence) == false) {
+      return true; // being modified concurrently (dirty): nothing to verify
+    }
     machine_word_t parity = self(obj).parity;
-    JPTL::MemberIterator<TypeInfo, HammingCodeParity, HammingCodeInfoInit<STATIC, DIMENSION> >::exec(obj, &parity);
+    MemberTraversal<TypeInfo, HammingCodeParity, HammingCodeInfoInit<STATIC, DIMENSION> >::exec(obj, &parity);
     if(parity != CHECKSUM_INIT) {
       // checksum error ... now let's find the cause
       // test whether we had not been interrupted while verifying the checksum
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         // okay, we found bit errors ... so let's repair
         return __repair(obj);
       }
@@ -551,12 +566,16 @@ class ChecksummingHamming : public ChecksummingBase<TypeInfo, STATIC> { // Check
     }
     //ClearHammigArray<DIMENSION>::clear(self(obj).hammingArray); // loop-unrolled template metaprogram (slower, somehow)
     self(obj).parity = CHECKSUM_INIT;
-    JPTL::MemberIterator<TypeInfo, HammingCodeGenerate, HammingCodeInfoInit<STATIC, DIMENSION> >::exec(obj, self(obj).hammingArray, &self(obj).parity);
+    MemberTraversal<TypeInfo, HammingCodeGenerate, HammingCodeInfoInit<STATIC, DIMENSION> >::exec(obj, self(obj).hammingArray, &self(obj).parity);
     // re-construct the global parity from hammingArray[0]
     self(obj).parity ^= self(obj).hammingArray[0];
     self(obj).inc_version(); // increment version counter
     self(obj).reset_dirty();
   }
+
+  // no incremental update (see Checksumming_SUM+DMR.h): __commit() re-generates the Hamming code
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(T* obj) { __generate(obj); }
   
   // ctor for static checksum, only: initialization on startup, before "main"
   ChecksummingHamming() {
@@ -570,14 +589,14 @@ class ChecksummingHamming : public ChecksummingBase<TypeInfo, STATIC> { // Check
 template<typename TypeInfo, bool STATIC, unsigned tSIZE>
 bool ChecksummingHamming<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
   // stop preemption from now (FIXME: only for T::SYNCHRONIZED==1)
-  StopPreemption stop; // constructor/destructor pattern
+  StopPreemption stop(&self(obj)); // constructor/destructor pattern, one lock per address stripe
 
   // The detected error could have been fixed by another thread,
   // while we had been waiting for the StopPreemption lock
   // Thus, check again ...
   if(self(obj).get_dirty() == 0) {
     // checksum is still valid (not dirty)
-    unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
 
     // re-calculate parity and hamming code
     machine_word_t hammingArray[DIMENSION];
@@ -585,11 +604,11 @@ bool ChecksummingHamming<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
     for(unsigned int i=0; i<DIMENSION; i++) {
       hammingArray[i] = self(obj).hammingArray[i];
     }
-    JPTL::MemberIterator<TypeInfo, HammingCodeGenerate, HammingCodeInfoInit<STATIC, DIMENSION, false> >::exec(obj, hammingArray, &parity);
+    MemberTraversal<TypeInfo, HammingCodeGenerate, HammingCodeInfoInit<STATIC, DIMENSION, false> >::exec(obj, hammingArray, &parity);
     // re-construct the global parity from hammingArray[0]
     parity ^= (hammingArray[0] ^ self(obj).hammingArray[0]);
 
-    if( (parity == 0) || (self(obj).get_dirty() != 0) || (version != self(obj).get_version()) ) {
+    if( (parity == 0) || (self(obj).is_valid(sequence) == false) ) {
       return true; // this error has been fixed already by someone else
     }
     //return false; // for DEBUG only: catch false-positives
@@ -631,7 +650,7 @@ bool ChecksummingHamming<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
         }
         // cout << TypeInfo::signature() << ": syndrome: " << syndrome << " (bitpos: " << bitpos << ")" << endl;
         // fix the particular error:
-        JPTL::MemberIterator<TypeInfo, HammingCodeRepair, HammingCodeInfoInit<STATIC, DIMENSION> >::exec(obj, syndrome, bitpos);
+        MemberTraversal<TypeInfo, HammingCodeRepair, HammingCodeInfoInit<STATIC, DIMENSION> >::exec(obj, syndrome, bitpos);
       }
       error_detected = error_detected >> 1;
     }
@@ -648,6 +667,8 @@ class ChecksummingHamming<TypeInfo, STATIC, 0> : public ChecksummingBase<TypeInf
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(typename TypeInfo::That* obj) { return true; }
   __attribute__((always_inline)) inline static void __generate(typename TypeInfo::That* obj) {}
+  __attribute__((always_inline)) inline static void __update(typename TypeInfo::That* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(typename TypeInfo::That* obj) {}
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(typename TypeInfo::That* obj, U* checksum) { *checksum = 0; return true; }
 };
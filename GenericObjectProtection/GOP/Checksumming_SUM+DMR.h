@@ -24,6 +24,7 @@
 #include "JPTL.h"
 #include "StopPreemption.h"
 #include "MemoryBarriers.h"
+#include "AtomicRepair.h"
 
 //#include <cyg/infra/diag.h> // diag_printf
 //#include <stdio.h>
@@ -166,6 +167,28 @@ struct CopyAndSum {
   }
 };
 
+// incremental variant of CopyAndSum for the member containing 'member': the shadow copy holds the old value
+struct SumUpdateState { // (the iterators pass three arguments at most)
+  long checksum;
+  unsigned char* dstArray;
+};
+
+template<typename MemberInfo, typename LAST>
+struct UpdateAndSum {
+  // compile-time calculations
+  typedef typename DMRInfo<MemberInfo, LAST>::EXEC EXEC;
+
+  template<typename T>
+  __attribute__((always_inline)) inline static void exec(T obj, const void* member, SumUpdateState* state) {
+    if((EXEC::MEMBER_IS_CHECKSUMMED == true) && MemberContains<MemberInfo, EXEC::SIZE>(obj, member)) {
+      unsigned char* shadow = &state->dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX];
+      state->checksum -= TWOSUM<EXEC::SIZE>::gen(0, shadow); // subtract the old value
+      state->checksum = TWOSUM<EXEC::SIZE>::gen(state->checksum, (const void*) MemberInfo::pointer(obj)); // add the new one
+      __builtin_memcpy(shadow, (const void*)MemberInfo::pointer(obj), EXEC::SIZE);
+    }
+  }
+};
+
 template<typename MemberInfo, typename LAST>
 struct SumOnly {
   // compile-time calculations
@@ -210,13 +233,28 @@ struct CopyRepair {
   }
 };
 
+// lock-free variant of CopyRepair for word-sized members (see AtomicRepair.h)
+template<typename MemberInfo, typename LAST>
+struct CopyRepairAtomic {
+  // compile-time calculations
+  typedef typename DMRInfo<MemberInfo, LAST>::EXEC EXEC;
+
+  template<typename T, typename State>
+  __attribute__((always_inline)) inline static void exec(T obj, unsigned char* dstArray, State* state) {
+    if(EXEC::MEMBER_IS_CHECKSUMMED == true) {
+      AtomicRepair<EXEC::SIZE>::exec((void*)MemberInfo::pointer(obj), &dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX],
+                                     &dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX], state);
+    }
+  }
+};
+
 //-----------------------------------
 
 
 template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
 // once again, puma is not willing to accept this ... :-(
 #ifndef __puma
-JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
+MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
 #else
 0
 #endif
@@ -246,9 +284,9 @@ class ChecksummingSUMDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(T* obj, U* checksum) {
     if(self(obj).get_dirty() == 0) {
-      const unsigned int version = self(obj).get_version();
+      const unsigned long long sequence = self(obj).get_sequence();
       *checksum = self(obj).checksum;
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         return true; // checksum valid
       }
     }
@@ -256,13 +294,16 @@ class ChecksummingSUMDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
   }
 
   __attribute__((always_inline)) inline static bool __check(T* obj) {
-    const unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
+    if(self(obj).is_valid(sequence) == false) {
+      return true; // being modified concurrently (dirty): nothing to verify
+    }
     long checksum_tmp = CHECKSUM_INIT;
-    JPTL::MemberIterator<TypeInfo, SumOnly, DMRInit<STATIC> >::exec(obj, &checksum_tmp);
+    MemberTraversal<TypeInfo, SumOnly, DMRInit<STATIC> >::exec(obj, &checksum_tmp);
     if(self(obj).checksum != checksum_tmp) {
       // checksum error ... now let's find the cause
       // test whether we had not been interrupted while verifying the checksum
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         // okay, we found bit errors ... so let's repair
         return __repair(obj);
       }
@@ -273,11 +314,24 @@ class ChecksummingSUMDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
   __attribute__((always_inline)) inline static void __generate(T* obj) {
     // dirty has to be set to *before* this function is entered (and before the locker is unlocked), see: LockAdviceInvoker.ah
     long checksum_tmp = CHECKSUM_INIT; // calculate checksum, and store intermediate results on our own stack
-    JPTL::MemberIterator<TypeInfo, CopyAndSum, DMRInit<STATIC> >::exec(obj, &checksum_tmp, getShadowAttribs(obj));
+    MemberTraversal<TypeInfo, CopyAndSum, DMRInit<STATIC> >::exec(obj, &checksum_tmp, getShadowAttribs(obj));
     self(obj).checksum = checksum_tmp; // finally, update the object's checksum by a single copy instruction
     self(obj).inc_version(); // increment version counter
     self(obj).reset_dirty();
   }
+
+  // incremental variant of __generate(), after a write to a single member (the one containing 'member'):
+  // costs O(sizeof(member)) instead of O(SIZE). Several __update() calls are completed by one __commit().
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) {
+    // dirty has to be set before, as for __generate()
+    SumUpdateState state = { self(obj).checksum, getShadowAttribs(obj) };
+    MemberTraversal<TypeInfo, UpdateAndSum, DMRInit<STATIC> >::exec(obj, member, &state);
+    self(obj).checksum = state.checksum;
+  }
+  __attribute__((always_inline)) inline static void __commit(T* obj) {
+    self(obj).inc_version(); // increment version counter
+    self(obj).reset_dirty();
+  }
   
   // ctor for static checksum, only: initialization on startup, before "main"
   ChecksummingSUMDMR() {
@@ -290,18 +344,38 @@ class ChecksummingSUMDMR : public ChecksummingBase<TypeInfo, STATIC> { // Checks
 
 template<typename TypeInfo, bool STATIC, unsigned tSIZE>
 bool ChecksummingSUMDMR<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
+  // first, try to repair word-sized members lock-free
+  if(MemberTraversal<TypeInfo, AtomicRepairable, AtomicRepairableInit<STATIC> >::EXEC::WORDS != 0) {
+    AtomicRepairState<ChecksummingSUMDMR> state(&self(obj), self(obj).get_sequence());
+    long checksum_shadow = CHECKSUM_INIT;
+    MemberTraversal<TypeInfo, SumShadow, DMRInit<STATIC> >::exec(&checksum_shadow, getShadowAttribs(obj));
+    const bool object_faulty = (checksum_shadow == self(obj).checksum); // shadow copy and checksum agree
+    if(self(obj).is_valid(state.sequence) == false) {
+      return true; // dirty bit set ... fine, object already in use
+    }
+    if(object_faulty) {
+      MemberTraversal<TypeInfo, CopyRepairAtomic, DMRInit<STATIC> >::exec(obj, getShadowAttribs(obj), &state);
+      if(state.corrected) {
+        errorCorrected();
+      }
+      if(state.needs_lock == false) {
+        return true; // repaired, or modified concurrently
+      }
+    }
+  }
+
   // stop preemption from now (FIXME: only for T::SYNCHRONIZED==1)
-  StopPreemption stop; // constructor/destructor pattern
+  StopPreemption stop(&self(obj)); // constructor/destructor pattern, one lock per address stripe
 
   // The detected error could have been fixed by another thread,
   // while we had been waiting for the StopPreemption lock
   // Thus, check again ...
   if(self(obj).get_dirty() == 0) {
     // checksum is still valid (not dirty)
-    unsigned int version = self(obj).get_version(); // remember which checksum we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which checksum we're verifying
     long checksum_tmp = CHECKSUM_INIT;
-    JPTL::MemberIterator<TypeInfo, SumOnly, DMRInit<STATIC> >::exec(obj, &checksum_tmp); //TODO: don't unroll (rare case)
-    if( (self(obj).checksum == checksum_tmp) || (self(obj).get_dirty() != 0) || (version != self(obj).get_version()) ) {
+    MemberTraversal<TypeInfo, SumOnly, DMRInit<STATIC> >::exec(obj, &checksum_tmp); //TODO: don't unroll (rare case)
+    if( (self(obj).checksum == checksum_tmp) || (self(obj).is_valid(sequence) == false) ) {
       return true; // this error has been fixed already by someone else
     }
     //return false; // for DEBUG only: catch false-positives
@@ -309,11 +383,11 @@ bool ChecksummingSUMDMR<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
     // we have a real error somewhere ... let's find out
     long checksum_shadow = CHECKSUM_INIT;
     // do not use TWOSUM<SIZE>::gen(...) directly, since small members (char, short, ...) would be added differently
-    JPTL::MemberIterator<TypeInfo, SumShadow, DMRInit<STATIC> >::exec(&checksum_shadow, getShadowAttribs(obj)); //TODO: don't unroll (rare case)
+    MemberTraversal<TypeInfo, SumShadow, DMRInit<STATIC> >::exec(&checksum_shadow, getShadowAttribs(obj)); //TODO: don't unroll (rare case)
     if(checksum_shadow == self(obj).checksum) {
       // real object is faulty!
       self(obj).checksum = ~checksum_shadow; // ensure the checksum won't match (while repairing)
-      JPTL::MemberIterator<TypeInfo, CopyRepair, DMRInit<STATIC> >::exec(obj, getShadowAttribs(obj));
+      MemberTraversal<TypeInfo, CopyRepair, DMRInit<STATIC> >::exec(obj, getShadowAttribs(obj));
       self(obj).checksum = checksum_shadow; // restore proper checksum
       errorCorrected();
     }
@@ -338,6 +412,8 @@ class ChecksummingSUMDMR<TypeInfo, STATIC, 0> : public ChecksummingBase<TypeInfo
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(typename TypeInfo::That* obj) { return true; }
   __attribute__((always_inline)) inline static void __generate(typename TypeInfo::That* obj) {}
+  __attribute__((always_inline)) inline static void __update(typename TypeInfo::That* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(typename TypeInfo::That* obj) {}
   template<typename U>
   __attribute__((always_inline)) inline static bool getChecksum(typename TypeInfo::That* obj, U* checksum) { *checksum = 0; return true; }
 };
@@ -24,6 +24,7 @@
 #include "JPTL.h"
 #include "StopPreemption.h"
 #include "MemoryBarriers.h"
+#include "AtomicRepair.h"
 
 //#include <cyg/infra/diag.h> // diag_printf
 //#include <stdio.h>
@@ -74,6 +75,21 @@ struct TMRCopy {
 };
 
 
+// TMRCopy for the member containing 'member' only
+template<typename MemberInfo, typename LAST>
+struct TMRUpdate {
+  // compile-time calculations
+  typedef typename TMRInfo<MemberInfo, LAST>::EXEC EXEC;
+
+  template<typename T>
+  __attribute__((always_inline)) inline static void exec(T obj, const void* member, unsigned char* dstArray) {
+    if((EXEC::MEMBER_IS_CHECKSUMMED == true) && MemberContains<MemberInfo, EXEC::SIZE>(obj, member)) {
+      __builtin_memcpy(&dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX_1], (const void*)MemberInfo::pointer(obj), EXEC::SIZE); // copy 1
+      __builtin_memcpy(&dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX_2], (const void*)MemberInfo::pointer(obj), EXEC::SIZE); // copy 2
+    }
+  }
+};
+
 template<typename MemberInfo, typename LAST>
 struct TMRRepair {
   // compile-time calculations
@@ -114,13 +130,28 @@ struct TMRCheck {
   }
 };
 
+// lock-free variant of TMRRepair for word-sized members (see AtomicRepair.h)
+template<typename MemberInfo, typename LAST>
+struct TMRRepairAtomic {
+  // compile-time calculations
+  typedef typename TMRInfo<MemberInfo, LAST>::EXEC EXEC;
+
+  template<typename T, typename State>
+  __attribute__((always_inline)) inline static void exec(T obj, unsigned char* dstArray, State* state) {
+    if(EXEC::MEMBER_IS_CHECKSUMMED == true) {
+      AtomicRepair<EXEC::SIZE>::exec((void*)MemberInfo::pointer(obj), &dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX_1],
+                                     &dstArray[EXEC::CURRENT_SHADOW_ARRAY_INDEX_2], state);
+    }
+  }
+};
+
 //-----------------------------------
 
 
 template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
 // once again, puma is not willing to accept this ... :-(
 #ifndef __puma
-JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
+MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
 #else
 0
 #endif
@@ -146,13 +177,16 @@ class ChecksummingTMR : public ChecksummingBase<TypeInfo, STATIC> { // Checksumm
 
   public:
   __attribute__((always_inline)) inline static bool __check(T* obj) {
-    unsigned int version = self(obj).get_version(); // remember which replicas we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which replicas we're verifying
+    if(self(obj).is_valid(sequence) == false) {
+      return true; // being modified concurrently (dirty): nothing to verify
+    }
     int errros_found = 0;
-    JPTL::MemberIterator<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
+    MemberTraversal<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
     if(errros_found != 0) {
       // error(s) found ... now let's find the cause
       // test whether we had not been interrupted while verifying the checksum
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         // okay, we found bit errors ... so let's repair
         return __repair(obj);
       }
@@ -162,7 +196,17 @@ class ChecksummingTMR : public ChecksummingBase<TypeInfo, STATIC> { // Checksumm
 
   __attribute__((always_inline)) inline static void __generate(T* obj) {
     // dirty has to be set to *before* this function is entered (and before the locker is unlocked), see: LockAdviceInvoker.ah
-    JPTL::MemberIterator<TypeInfo, TMRCopy, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj));
+    MemberTraversal<TypeInfo, TMRCopy, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj));
+    self(obj).inc_version(); // increment version counter
+    self(obj).reset_dirty();
+  }
+
+  // incremental variant of __generate(), after a write to a single member: only its replicas are copied
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) {
+    // dirty has to be set before, as for __generate()
+    MemberTraversal<TypeInfo, TMRUpdate, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, member, getShadowAttribs(obj));
+  }
+  __attribute__((always_inline)) inline static void __commit(T* obj) {
     self(obj).inc_version(); // increment version counter
     self(obj).reset_dirty();
   }
@@ -178,18 +222,33 @@ class ChecksummingTMR : public ChecksummingBase<TypeInfo, STATIC> { // Checksumm
 
 template<typename TypeInfo, bool STATIC, unsigned tSIZE>
 bool ChecksummingTMR<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
+  // first, try to repair word-sized members lock-free
+  if(MemberTraversal<TypeInfo, AtomicRepairable, AtomicRepairableInit<STATIC> >::EXEC::WORDS != 0) {
+    AtomicRepairState<ChecksummingTMR> state(&self(obj), self(obj).get_sequence());
+    if(self(obj).is_valid(state.sequence) == false) {
+      return true; // dirty bit set ... fine, object already in use
+    }
+    MemberTraversal<TypeInfo, TMRRepairAtomic, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &state);
+    if(state.corrected) {
+      errorCorrected();
+    }
+    if(state.needs_lock == false) {
+      return true; // repaired, or modified concurrently
+    }
+  }
+
   // stop preemption from now (FIXME: only for T::SYNCHRONIZED==1)
-  StopPreemption stop; // constructor/destructor pattern
+  StopPreemption stop(&self(obj)); // constructor/destructor pattern, one lock per address stripe
 
   // The detected error could have been fixed by another thread,
   // while we had been waiting for the StopPreemption lock
   // Thus, check again ...
   if(self(obj).get_dirty() == 0) {
     // checksum is still valid (not dirty)
-    const unsigned int version = self(obj).get_version(); // remember which replicas we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which replicas we're verifying
     int errros_found = 0;
-    JPTL::MemberIterator<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
-    if( (errros_found == 0) || (self(obj).get_dirty() != 0) || (version != self(obj).get_version()) ) {
+    MemberTraversal<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
+    if( (errros_found == 0) || (self(obj).is_valid(sequence) == false) ) {
       return true; // this error has been fixed already by someone else
     }
     //return false; // for DEBUG only: catch false-positives
@@ -197,7 +256,7 @@ bool ChecksummingTMR<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
     // we have a real error somewhere ... let's find out
     // TODO FIXME XXX: ensure the replicas won't match (while repairing)
     bool result = true;
-    JPTL::MemberIterator<TypeInfo, TMRRepair, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &result);
+    MemberTraversal<TypeInfo, TMRRepair, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &result);
     return result;
   }
   return true; // dirty bit set ... fine, object already in use
@@ -211,6 +270,8 @@ class ChecksummingTMR<TypeInfo, STATIC, 0> : public ChecksummingBase<TypeInfo, S
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(typename TypeInfo::That* obj) { return true; }
   __attribute__((always_inline)) inline static void __generate(typename TypeInfo::That* obj) {}
+  __attribute__((always_inline)) inline static void __update(typename TypeInfo::That* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(typename TypeInfo::That* obj) {}
 };
 
 } //CoolChecksum
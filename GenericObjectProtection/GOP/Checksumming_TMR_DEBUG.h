@@ -70,7 +70,7 @@ struct TMRRepair_Debug {
 template<typename TypeInfo, bool STATIC=false, unsigned tSIZE=
 // once again, puma is not willing to accept this ... :-(
 #ifndef __puma
-JPTL::MemberIterator<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
+MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<STATIC> >::EXEC::SIZE
 #else
 0
 #endif
@@ -96,13 +96,16 @@ class ChecksummingTMRDebug : public ChecksummingBase<TypeInfo, STATIC> { // Chec
 
   public:
   __attribute__((always_inline)) inline static bool __check(T* obj) {
-    const unsigned int version = self(obj).get_version(); // remember which replicas we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which replicas we're verifying
+    if(self(obj).is_valid(sequence) == false) {
+      return true; // being modified concurrently (dirty): nothing to verify
+    }
     int errros_found = 0;
-    JPTL::MemberIterator<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
+    MemberTraversal<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
     if(errros_found != 0) {
       // error(s) found ... now let's find the cause
       // test whether we had not been interrupted while verifying the checksum
-      if( (self(obj).get_dirty() == 0) && (version == self(obj).get_version()) ) {
+      if(self(obj).is_valid(sequence)) {
         // okay, we found bit errors ... so let's repair
         return __repair(obj);
       }
@@ -112,10 +115,14 @@ class ChecksummingTMRDebug : public ChecksummingBase<TypeInfo, STATIC> { // Chec
 
   __attribute__((always_inline)) inline static void __generate(T* obj) {
     // dirty has to be set to *before* this function is entered (and before the locker is unlocked), see: LockAdviceInvoker.ah
-    JPTL::MemberIterator<TypeInfo, TMRCopy, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj));
+    MemberTraversal<TypeInfo, TMRCopy, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj));
     self(obj).inc_version(); // increment version counter
     self(obj).reset_dirty();
   }
+
+  // no incremental update (see Checksumming_SUM+DMR.h): __commit() re-generates the replicas
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(T* obj) { __generate(obj); }
   
   // ctor for static checksum, only: initialization on startup, before "main"
   ChecksummingTMRDebug() {
@@ -129,17 +136,17 @@ class ChecksummingTMRDebug : public ChecksummingBase<TypeInfo, STATIC> { // Chec
 template<typename TypeInfo, bool STATIC, unsigned tSIZE>
 bool ChecksummingTMRDebug<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
   // stop preemption from now (FIXME: only for T::SYNCHRONIZED==1)
-  StopPreemption stop; // constructor/destructor pattern
+  StopPreemption stop(&self(obj)); // constructor/destructor pattern, one lock per address stripe
 
   // The detected error could have been fixed by another thread,
   // while we had been waiting for the StopPreemption lock
   // Thus, check again ...
   if(self(obj).get_dirty() == 0) {
     // checksum is still valid (not dirty)
-    unsigned int version = self(obj).get_version(); // remember which replicas we're verifying
+    const unsigned long long sequence = self(obj).get_sequence(); // remember which replicas we're verifying
     int errros_found = 0;
-    JPTL::MemberIterator<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
-    if( (errros_found == 0) || (self(obj).get_dirty() != 0) || (version != self(obj).get_version()) ) {
+    MemberTraversal<TypeInfo, TMRCheck, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &errros_found);
+    if( (errros_found == 0) || (self(obj).is_valid(sequence) == false) ) {
       return true; // this error has been fixed already by someone else
     }
     //return false; // for DEBUG only: catch false-positives
@@ -147,7 +154,7 @@ bool ChecksummingTMRDebug<TypeInfo, STATIC, tSIZE>::__repair(T* obj) {
     // we have a real error somewhere ... let's find out
     // TODO FIXME XXX: ensure the replicas won't match (while repairing)
     bool result = true;
-    JPTL::MemberIterator<TypeInfo, TMRRepair_Debug, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &result);
+    MemberTraversal<TypeInfo, TMRRepair_Debug, TMRInit<STATIC, ALIGNED_SIZE> >::exec(obj, getShadowAttribs(obj), &result);
     return result;
   }
   return true; // dirty bit set ... fine, object already in use
@@ -161,6 +168,8 @@ class ChecksummingTMRDebug<TypeInfo, STATIC, 0> : public ChecksummingBase<TypeIn
   enum { SIZE = 0 };
   __attribute__((always_inline)) inline static bool __check(typename TypeInfo::That* obj) { return true; }
   __attribute__((always_inline)) inline static void __generate(typename TypeInfo::That* obj) {}
+  __attribute__((always_inline)) inline static void __update(typename TypeInfo::That* obj, const void* member) {}
+  __attribute__((always_inline)) inline static void __commit(typename TypeInfo::That* obj) {}
 };
 
 } //CoolChecksum
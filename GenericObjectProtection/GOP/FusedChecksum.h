@@ -0,0 +1,223 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __FUSED_CHECKSUM_H__
+#define __FUSED_CHECKSUM_H__
+
+#include "GOP_GlobalConfig.h"
+#include "ObjectSize.h"
+#include "JPTL.h"
+#include "WholeObject.h"
+#include "Actions.h"
+
+
+// base classes must dispatch to the checksum of the actual object (see below)
+#if GOP_USE_FUSED_CHECKSUM
+#define GOP_FUSED_VIRTUAL virtual
+#else
+#define GOP_FUSED_VIRTUAL
+#endif
+
+
+namespace CoolChecksum {
+
+// GOP_USE_FUSED_CHECKSUM: for classes with inheritance whose hierarchy has no static members,
+// the checksum of the most-derived class covers the members of all its (protected) base classes.
+// Thus, __enter()/__leave() verify/generate a single checksum, instead of one per base class.
+// The base classes' checksums stay in the object (same layout), but are not maintained for
+// objects of a derived class. Hence, base classes must not verify such an object on their own:
+// __enter_get() and __scrub() become virtual, and the destruction of a derived class
+// re-generates the checksums of its direct base classes (see ChecksumAdviceInvoker.ah).
+
+
+// pseudo type info: the members of TypeInfo and of all its protected base classes
+template<typename TypeInfo>
+struct HierarchyInfo {
+  typedef typename TypeInfo::That That;
+  enum { HASHCODE = TypeInfo::HASHCODE };
+};
+
+// the type info a class's checksum is instantiated with
+template<typename TypeInfo, bool FUSED>
+struct ChecksumTypeInfo {
+  typedef TypeInfo Type;
+};
+template<typename TypeInfo>
+struct ChecksumTypeInfo<TypeInfo, true> {
+  typedef HierarchyInfo<TypeInfo> Type;
+};
+
+
+#ifndef __acweaving
+
+// like JPTL::BaseMemberIterator, but skips the members of classes that are not protected
+// (e.g., a non-critical base class), as those are modified without entering the object
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename LAST_EXEC,
+         bool PROTECTED=(bool)__hasChecksumFunctions<typename TypeInfo::That>::RET,
+         unsigned I=TypeInfo::BASECLASSES>
+struct HierarchyMemberIterator {
+
+  //base type information
+  typedef typename TypeInfo::template BaseClass<I-1>::Type BASE_TYPE;
+  typedef AC::TypeInfo<BASE_TYPE> BASE_TYPE_INFO;
+
+  // cast (a pointer) from TypeInfo::That* to BASE_TYPE*, pass other arguments as they are
+  template<typename T>
+  __attribute__((always_inline)) inline static T base_cast(T arg) { return arg; }
+  __attribute__((always_inline)) inline static BASE_TYPE* base_cast(typename TypeInfo::That* arg) {
+    return (BASE_TYPE*)arg;
+  }
+  __attribute__((always_inline)) inline static const BASE_TYPE* base_cast(const typename TypeInfo::That* arg) {
+    return (const BASE_TYPE*)arg;
+  }
+  __attribute__((always_inline)) inline static volatile BASE_TYPE* base_cast(volatile typename TypeInfo::That* arg) {
+    return (volatile BASE_TYPE*)arg;
+  }
+  __attribute__((always_inline)) inline static const volatile BASE_TYPE* base_cast(const volatile typename TypeInfo::That* arg) {
+    return (const volatile BASE_TYPE*)arg;
+  }
+
+  // calculation of the context type
+  typedef typename HierarchyMemberIterator<BASE_TYPE_INFO, Action, LAST_EXEC>::EXEC PREV_EXEC; // recursion to the current base class
+  typedef typename HierarchyMemberIterator<TypeInfo, Action, PREV_EXEC, PROTECTED, I-1>::EXEC EXEC; // process next base class
+
+  // the exec(...) function
+  template<typename ARG_0>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0) {
+    HierarchyMemberIterator<BASE_TYPE_INFO, Action, LAST_EXEC>::exec( base_cast(arg0) );
+    HierarchyMemberIterator<TypeInfo, Action, PREV_EXEC, PROTECTED, I-1>::exec(arg0);
+  }
+  template<typename ARG_0, typename ARG_1>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1) {
+    HierarchyMemberIterator<BASE_TYPE_INFO, Action, LAST_EXEC>::exec( base_cast(arg0), base_cast(arg1) );
+    HierarchyMemberIterator<TypeInfo, Action, PREV_EXEC, PROTECTED, I-1>::exec(arg0, arg1);
+  }
+  template<typename ARG_0, typename ARG_1, typename ARG_2>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1, ARG_2 arg2) {
+    HierarchyMemberIterator<BASE_TYPE_INFO, Action, LAST_EXEC>::exec( base_cast(arg0), base_cast(arg1), base_cast(arg2) );
+    HierarchyMemberIterator<TypeInfo, Action, PREV_EXEC, PROTECTED, I-1>::exec(arg0, arg1, arg2);
+  }
+};
+
+// Specialization for I=0: the members of the class itself
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename LAST_EXEC>
+struct HierarchyMemberIterator<TypeInfo, Action, LAST_EXEC, true, 0> : public JPTL::MemberIterator<TypeInfo, Action, LAST_EXEC> {};
+
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename LAST_EXEC>
+struct HierarchyMemberIterator<TypeInfo, Action, LAST_EXEC, false, 0> {
+  typedef LAST_EXEC EXEC;
+  template<typename ARG_0>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0) {}
+  template<typename ARG_0, typename ARG_1>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1) {}
+  template<typename ARG_0, typename ARG_1, typename ARG_2>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1, ARG_2 arg2) {}
+};
+
+#else // __acweaving
+
+// dummy iterator to speed up the weaving phase (see JPTL.h)
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename LAST_EXEC,
+         bool PROTECTED=true,
+         unsigned I=0>
+struct HierarchyMemberIterator : public JPTL::MemberIterator<TypeInfo, Action, LAST_EXEC> {};
+
+#endif // __acweaving
+
+
+// the members of base classes are not contiguous (their checksums lie in between)
+template<typename TypeInfo, bool STATIC>
+struct WholeObject<HierarchyInfo<TypeInfo>, STATIC> {
+  enum { ENABLED = 0, SIZE = 0 };
+  __attribute__((always_inline)) inline static void zero_padding(typename TypeInfo::That* obj) {}
+};
+
+// all Checksumming_* variants traverse the whole hierarchy in a single pass
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename INIT>
+struct MemberTraversal<HierarchyInfo<TypeInfo>, Action, INIT, false> :
+  public HierarchyMemberIterator<TypeInfo, Action, INIT, true> {}; // the class itself is protected (and still incomplete)
+
+
+// Replaces JPTL::BaseIterator for the actions on the (non-static) checksums, e.g., Check:
+// the fused checksum of the class itself, or the checksums of all its base classes
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         bool FUSED=(bool)TypeInfo::That::FUSED_CHECKSUM>
+struct HierarchyIterator : public JPTL::BaseIterator<TypeInfo, Action> {};
+
+template<typename TypeInfo,
+         template <typename, typename> class Action>
+struct HierarchyIterator<TypeInfo, Action, true> {
+  template<typename ARG_0>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0) {
+    Action<TypeInfo, void>::exec(arg0);
+  }
+  template<typename ARG_0, typename ARG_1>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1) {
+    Action<TypeInfo, void>::exec(arg0, arg1);
+  }
+};
+
+
+// On destruction, the direct base classes verify the object on their own (qualified __enter()),
+// thus, their checksums are re-generated after the destructor of a fused class.
+// Non-protected base classes are skipped, but not their base classes.
+template<typename TypeInfo,
+         unsigned I=TypeInfo::BASECLASSES>
+struct FusedBases {
+  typedef typename TypeInfo::template BaseClass<I-1>::Type BASE_TYPE;
+
+  template<typename T, int PROTECTED=__hasChecksumFunctions<T>::RET>
+  struct Base {
+    __attribute__((always_inline)) inline static void generate(T* obj) {
+      __ConditionalCall<T>::__dirty(obj);
+      __ConditionalCall<T>::__generate(obj);
+    }
+  };
+  template<typename T>
+  struct Base<T, 0> {
+    __attribute__((always_inline)) inline static void generate(T* obj) {
+      FusedBases<AC::TypeInfo<T> >::generate(obj);
+    }
+  };
+
+  __attribute__((always_inline)) inline static void generate(typename TypeInfo::That* obj) {
+    Base<BASE_TYPE>::generate((BASE_TYPE*)obj);
+    FusedBases<TypeInfo, I-1>::generate(obj);
+  }
+};
+
+template<typename TypeInfo>
+struct FusedBases<TypeInfo, 0> {
+  __attribute__((always_inline)) inline static void generate(typename TypeInfo::That* obj) {}
+};
+
+} //CoolChecksum
+
+#endif /* __FUSED_CHECKSUM_H__ */
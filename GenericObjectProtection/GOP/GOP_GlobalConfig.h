@@ -21,4 +21,75 @@
 
 #define GOP_USE_GET_SET_ADVICE 1
 
+// Checksum the range [first checksummed member, last checksummed member] as one block,
+// including the padding bytes in between (see WholeObject.h). The padding is zeroed
+// after construction; copy-assignment keeps it zeroed, as the source's padding is zero, too.
+// Classes whose range contains non-checksummed members fall back to the member-wise iteration.
+#define GOP_USE_WHOLE_OBJECT_CHECKSUM 0
+
+// One checksum per object for classes with inheritance, instead of one per (protected) base class:
+// the most-derived class covers the members of its base classes (see FusedChecksum.h).
+// Only hierarchies without static members are fused; __enter_get() and __scrub() become virtual.
+#define GOP_USE_FUSED_CHECKSUM 0
+
+// split the static checksum of a class into independently verified segments (see StaticSegments.h):
+// one per static member, and one per GOP_STATIC_SEGMENT_SIZE bytes of larger members (arrays).
+// A get access from outside the class verifies the segment of the accessed member only.
+// The segment size has to be a multiple of the largest scalar type (16 bytes).
+#define GOP_USE_STATIC_SEGMENTS 0
+#define GOP_STATIC_SEGMENT_SIZE 256
+
+// cache-line size of the target platform [bytes]
+#define GOP_CACHE_LINE_SIZE 64
+
+// number of locks serializing concurrent __repair(...) calls (see StopPreemption.h)
+// objects are mapped to a lock by their address, so unrelated repairs proceed in parallel
+#define GOP_REPAIR_LOCK_STRIPES 64
+
+// pack the dirty flag and the version of each checksum into one 64-bit word (see ChecksummingBase.h):
+// verifying becomes a single load/compare, and the per-object metadata shrinks by 8 bytes
+#define GOP_USE_SEQLOCK_FLAGS 0
+
+// emit __check/__generate once per class (noinline), instead of inlining them into
+// every __enter/__leave of the class and of all its derived classes (see Actions.h)
+#define GOP_OUTLINE_CHECKSUM_FUNCTIONS 0
+
+// number of reader slots (one cache line each) shared by all readMostlyClasses() (see ReaderLocker.h)
+// threads are assigned to the slots round-robin; should be at least the number of CPUs
+#define GOP_READER_SLOTS 64
+
+// number of objects a thread can hold at the same time, with nested enters/leaves being
+// counted thread-locally instead of in the shared locker (see NestingStack.h), e.g., 8.
+// Changes the enter/leave path of all synchronizedClasses(); 0 disables (default)
+#define GOP_NESTING_STACK_SIZE 0
+
+// 1: __enter() does not verify the checksum (it is still generated on leave). Objects are
+// verified before the calls to the verifyPoints() only, and by the Scrubber (see VerifyPoints.h).
+// Bit flips in between are not detected, but incorporated into the next checksum.
+#define GOP_VERIFY_AT_BOUNDARIES 0
+
+// number of CoolChecksum::Session objects a thread can hold open at the same time (see Session.h);
+// further sessions fall back to the per-call advice. 0 disables sessions
+#define GOP_SESSION_STACK_SIZE 4
+
+// number of shards (one cache line each) per class in the registry of live objects
+// of the registeredClasses() (see Registry.h); objects are mapped to a shard by their address
+#define GOP_REGISTRY_SHARDS 16
+
+// background scrubbing of the registeredClasses() (see Scrubber.h): the budget of
+// verified bytes per second, and the CPU to pin the scrubber thread to (-1: not pinned)
+#define GOP_SCRUB_BYTES_PER_SECOND (1024*1024)
+#define GOP_SCRUB_CPU -1
+// parallel scrubbing: the number of worker threads (the first one is pinned to GOP_SCRUB_CPU,
+// the others to the following CPUs), and their priority: 0 normal, 1 batch and yielding
+// after each shard, 2 idle (runs only if a CPU has nothing else to do)
+#define GOP_SCRUB_WORKERS 1
+#define GOP_SCRUB_MAX_WORKERS 64
+#define GOP_SCRUB_PRIORITY 0
+
+// instrumentation build for the profile-guided static optimization (see Profiler.h):
+// records the enter/leave sequences per call site, with a buffer of records per thread
+#define GOP_PROFILE 0
+#define GOP_PROFILE_BUFFER 4096
+
 #endif // __GOP_GLOBAL_CONFIG_H__
@@ -21,7 +21,8 @@
 
 namespace CoolChecksum {
 
-//add -march=i486 to gcc flags for __sync_fetch_and_add builtins
+//the __atomic builtins (gcc >= 4.7) provide C++11-style acquire/release semantics for C++03 code
+//(add -march=i486 to gcc flags on 32-bit x86)
 
 //TODO: Rename this class to "Counter"
 
@@ -30,10 +31,13 @@ __attribute__((always_inline)) inline void synchronizerLockError() {}
 
 template<bool NOT_EMPTY>
 class ChksumLocker {
-  private:
+  protected:
   mutable unsigned int lock; // ANB-Encoded (A = 127, B = 5) //TODO: find optimal values
   enum { A_CONSTANT = 127,
-         B_CONSTANT = 5 };
+         B_CONSTANT = 5,
+         // added while the first to enter verifies (see __enter_lock()), a valid code word, too,
+         // as long as there are less than 2^16 holders
+         VERIFYING  = (A_CONSTANT << 16) };
 
 /*
   //FIXME: for error repair: uint32!!!
@@ -58,11 +62,14 @@ class ChksumLocker {
 */
 
   // check the ANB code
-  __attribute__((always_inline)) inline void __check() const {
-    if( ((this->lock) % A_CONSTANT) != B_CONSTANT ) {
+  __attribute__((always_inline)) inline static void __check(const unsigned int value) {
+    if( (value % A_CONSTANT) != B_CONSTANT ) {
       synchronizerLockError();
     }
   }
+  __attribute__((always_inline)) inline void __check() const {
+    __check(this->lock);
+  }
 
   public:
   inline ChksumLocker() : lock(B_CONSTANT) {}
@@ -76,19 +83,79 @@ class ChksumLocker {
     this->lock = (A_CONSTANT+B_CONSTANT);
   }
 
-  // just increment the lock value
+  // wait until the first to enter has verified the checksum(s), see __enter_lock()
+  __attribute__((noinline)) void __wait_verified() const {
+    while(__atomic_load_n(&(this->lock), __ATOMIC_ACQUIRE) >= VERIFYING) {} // spin read-only
+  }
+
+  // the slow path of __enter_lock(): the locker was not in its initial state
+  __attribute__((noinline)) bool __enter_lock_contended(unsigned int previous) const {
+    for(;;) {
+      if(previous == B_CONSTANT) { // all others have left in the meantime
+        if(__atomic_compare_exchange_n(&(this->lock), &previous, A_CONSTANT+B_CONSTANT+VERIFYING,
+                                       false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+          return true;
+        }
+      }
+      else if((previous >= VERIFYING) && ((previous % A_CONSTANT) == B_CONSTANT)) {
+        __wait_verified();
+        previous = __atomic_load_n(&(this->lock), __ATOMIC_RELAXED);
+      }
+      else {
+        __check(previous); // check for (possible) bit errors in the locker
+        if(__atomic_compare_exchange_n(&(this->lock), &previous, previous + A_CONSTANT,
+                                       false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+          return false; // verified by the first to enter, and maybe modified by others already
+        }
+      }
+    }
+  }
+
+  // just increment the lock value (but do not modify the object while it is being verified)
   __attribute__((always_inline)) inline void __lock() const {
-    __sync_fetch_and_add(&(this->lock), A_CONSTANT); // must be atomic
+    const unsigned int previous = __atomic_fetch_add(&(this->lock), A_CONSTANT, __ATOMIC_ACQUIRE); // must be atomic
+    if(__builtin_expect(previous >= VERIFYING, 0)) {
+      __wait_verified();
+    }
+  }
+
+  // lock and return 'true' when the locker was in its initial state, i.e., we are the first
+  // to enter and have to verify the checksum(s), followed by __verified() in any case.
+  // Until then, the locker is marked VERIFYING, and all later entrants wait: they skip the
+  // verification and modify the object, so that a mismatch found by the first would be taken
+  // for a modification in progress, and would never be repaired (see ChecksummingBase.h).
+  // Uncontended, a single read-modify-write replaces __is_unlocked() followed by __lock().
+  __attribute__((always_inline)) inline bool __enter_lock() const {
+    unsigned int previous = B_CONSTANT;
+    if(__atomic_compare_exchange_n(&(this->lock), &previous, A_CONSTANT+B_CONSTANT+VERIFYING,
+                                   false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+      return true; // valid code word => no __check()'ing
+    }
+    return __enter_lock_contended(previous);
   }
 
-  // just decrement the lock value
+  // the first to enter has verified (and repaired) the checksum(s): let the others in
+  __attribute__((always_inline)) inline void __verified() const {
+    __atomic_fetch_sub(&(this->lock), VERIFYING, __ATOMIC_RELEASE);
+  }
+
+  // just decrement the lock value (release: all modifications and the checksum are visible before)
   __attribute__((always_inline)) inline void __unlock() const {
-    /*
-    if(lock == B_CONSTANT) { // check for underflow (DEBUG only)
-      while(1);
+    const unsigned int previous = __atomic_fetch_sub(&(this->lock), A_CONSTANT, __ATOMIC_RELEASE); // must be atomic
+    if(previous != (A_CONSTANT+B_CONSTANT)) {
+      __check(previous); // check for (possible) bit errors in the locker
     }
-    */
-    __sync_fetch_and_sub(&(this->lock), A_CONSTANT); // must be atomic
+  }
+
+  // decrement the lock value, and return 'true' if we were the last to leave (see flat combining in LockAdviceInvoker.ah)
+  // acquire-release: the 'dirty' marks of all threads that have left before are visible afterwards
+  __attribute__((always_inline)) inline bool __leave_unlock() const {
+    const unsigned int previous = __atomic_fetch_sub(&(this->lock), A_CONSTANT, __ATOMIC_ACQ_REL); // must be atomic
+    if(previous == (A_CONSTANT+B_CONSTANT)) {
+      return true; // valid code word => no __check()'ing
+    }
+    __check(previous); // check for (possible) bit errors in the locker
+    return false;
   }
 
   // return 'false' when locked *only* by a single thread: we need to compute a new checksum before __unlock()'ing
@@ -100,9 +167,12 @@ class ChksumLocker {
     }
     else { return false; }
     */
-    return (this->lock != (A_CONSTANT+B_CONSTANT));
+    return (__atomic_load_n(&(this->lock), __ATOMIC_ACQUIRE) != (A_CONSTANT+B_CONSTANT));
   }
 
+  // there are no reader counters, see ChksumReaderLocker (ReaderLocker.h)
+  __attribute__((always_inline)) inline bool __has_readers() const { return false; }
+
   // return 'true' when the locker is in its initial state
   __attribute__((always_inline)) inline bool __is_unlocked() const {
     if(this->lock == B_CONSTANT) {
@@ -123,6 +193,10 @@ public:
   __attribute__((always_inline)) inline void __unlock() const {}
   __attribute__((always_inline)) inline bool __is_locked() const { return true; }
   __attribute__((always_inline)) inline bool __is_unlocked() const { return false; }
+  __attribute__((always_inline)) inline bool __enter_lock() const { return false; }
+  __attribute__((always_inline)) inline void __verified() const {}
+  __attribute__((always_inline)) inline bool __leave_unlock() const { return false; }
+  __attribute__((always_inline)) inline bool __has_readers() const { return false; }
   __attribute__((always_inline)) inline void __init_and_lock() const {}
 };
 
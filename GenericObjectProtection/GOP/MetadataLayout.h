@@ -0,0 +1,47 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __METADATA_LAYOUT_H__
+#define __METADATA_LAYOUT_H__
+
+#include "GOP_GlobalConfig.h"
+
+namespace CoolChecksum {
+
+// Layout policies for the woven __chksum and __locker members, selected per class
+// (see ChecksumIntroducer.ah). Both members are appended to the object, in this order.
+// In arrays of small synchronized objects, the lockers of adjacent objects would share
+// a cache line otherwise: every __enter()/__leave() of one object invalidates its neighbours.
+enum { METADATA_LAYOUT_PACKED = 0, // no alignment (default)
+       METADATA_LAYOUT_PADDED_LOCKER = 1, // the locker starts a cache line of its own
+       METADATA_LAYOUT_COLOCATED = 2 }; // checksum and locker start a cache line together
+
+// Aligning a member aligns the whole object, thus sizeof() is rounded up to whole cache lines:
+// the rest of the member's cache line belongs to the same object.
+// (an alignment of 1 never decreases the natural alignment of a member)
+// Note: before C++17, operator new does not honor alignments beyond the fundamental one,
+// i.e., heap-allocated objects need an aligned allocator to benefit.
+template<unsigned LAYOUT>
+struct MetadataLayout {
+  enum { CHECKSUM_ALIGNMENT = (LAYOUT == METADATA_LAYOUT_COLOCATED) ? GOP_CACHE_LINE_SIZE : 1,
+         LOCKER_ALIGNMENT = (LAYOUT == METADATA_LAYOUT_PADDED_LOCKER) ? GOP_CACHE_LINE_SIZE : 1 };
+};
+
+} //CoolChecksum
+
+#endif /* __METADATA_LAYOUT_H__ */
@@ -0,0 +1,107 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __NESTING_STACK_H__
+#define __NESTING_STACK_H__
+
+#include "GOP_GlobalConfig.h"
+
+namespace CoolChecksum {
+
+#if GOP_NESTING_STACK_SIZE
+
+// The lockers held by the calling thread, together with their nesting depth.
+// Only the outermost __enter()/__leave() pair of a thread touches the shared locker,
+// re-entering an object already held (e.g., by a callback from one of the
+// shortFunctions()) just counts locally: no atomics, no (re-)generation.
+class NestingStack {
+private:
+  const void* locker[GOP_NESTING_STACK_SIZE];
+  unsigned int depth[GOP_NESTING_STACK_SIZE]; // nested enters, beyond the outermost one
+  unsigned int top;
+
+  __attribute__((always_inline)) inline static NestingStack& self() {
+    static __thread NestingStack stack; // zero-initialized
+    return stack;
+  }
+
+public:
+  // returns 'true' on a nested enter; otherwise, the locker is pushed (if there is room left)
+  __attribute__((always_inline)) inline static bool enter(const void* id) {
+    NestingStack& stack = self();
+    for(unsigned int i = stack.top; i > 0; i--) {
+      if(stack.locker[i-1] == id) {
+        stack.depth[i-1]++;
+        return true;
+      }
+    }
+    if(stack.top < GOP_NESTING_STACK_SIZE) {
+      stack.locker[stack.top] = id;
+      stack.depth[stack.top] = 0;
+      stack.top++;
+    }
+    return false; // stack full: the shared locker does the counting, as usual
+  }
+
+  // returns 'true' on a nested leave; otherwise, the locker is popped (if found)
+  __attribute__((always_inline)) inline static bool leave(const void* id) {
+    NestingStack& stack = self();
+    for(unsigned int i = stack.top; i > 0; i--) {
+      if(stack.locker[i-1] == id) {
+        if(stack.depth[i-1] != 0) {
+          stack.depth[i-1]--;
+          return true;
+        }
+        stack.top--; // outermost leave: move the topmost entry into the gap
+        stack.locker[i-1] = stack.locker[stack.top];
+        stack.depth[i-1] = stack.depth[stack.top];
+        return false;
+      }
+    }
+    return false;
+  }
+
+  // on object destruction: the destructor's __enter() has no matching __leave()
+  __attribute__((always_inline)) inline static void forget(const void* id) {
+    NestingStack& stack = self();
+    for(unsigned int i = stack.top; i > 0; i--) {
+      if(stack.locker[i-1] == id) {
+        stack.top--;
+        stack.locker[i-1] = stack.locker[stack.top];
+        stack.depth[i-1] = stack.depth[stack.top];
+        return;
+      }
+    }
+  }
+};
+
+#else /* ! GOP_NESTING_STACK_SIZE */
+
+class NestingStack {
+public:
+  __attribute__((always_inline)) inline static bool enter(const void* id) { return false; }
+  __attribute__((always_inline)) inline static bool leave(const void* id) { return false; }
+  __attribute__((always_inline)) inline static void forget(const void* id) {}
+};
+
+#endif /* GOP_NESTING_STACK_SIZE */
+
+} //CoolChecksum
+
+#endif /* __NESTING_STACK_H__ */
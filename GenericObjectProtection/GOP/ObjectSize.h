@@ -32,12 +32,37 @@ __attribute__((always_inline)) inline const bool EqualPointers(const void* const
   return a == b;
 }
 
+// whether 'address' lies within the SIZE bytes of a member (see __update() of the Checksumming_* variants)
+// Note: for static members, this folds at compile time if 'address' is constant, too
+template<typename MemberInfo, unsigned SIZE, typename T>
+__attribute__((always_inline)) inline const bool MemberContains(T obj, const void* const address) {
+  const char* const first = (const char*)MemberInfo::pointer(obj);
+  return ((const char*)address >= first) && ((const char*)address < (first + SIZE));
+}
+
 // compare two types
 template<typename T, typename U>
 struct TypeTest { enum { EQUAL=0 }; };
 template<typename T>
 struct TypeTest<T,T> { enum { EQUAL=1 }; };
 
+// call __enter()/__leave() of the target: fully qualified (non-virtual, and thus inlinable)
+// if the static type is a leaf, i.e., has no protected derived classes (see leafClasses())
+template<typename T, int LEAF=T::LEAF>
+struct Devirtualize {
+  __attribute__((always_inline)) inline static bool enter(T* obj) { return obj->T::__enter(); }
+  __attribute__((always_inline)) inline static bool enter(const T* obj) { return obj->T::__enter(); }
+  __attribute__((always_inline)) inline static void leave(T* obj) { obj->T::__leave(); }
+  __attribute__((always_inline)) inline static void leave(const T* obj) { obj->T::__leave(); }
+};
+template<typename T>
+struct Devirtualize<T, 0> {
+  __attribute__((always_inline)) inline static bool enter(T* obj) { return obj->__enter(); }
+  __attribute__((always_inline)) inline static bool enter(const T* obj) { return obj->__enter(); }
+  __attribute__((always_inline)) inline static void leave(T* obj) { obj->__leave(); }
+  __attribute__((always_inline)) inline static void leave(const T* obj) { obj->__leave(); }
+};
+
 // static check, whether <T> has an attribute '__hasChecksumFunctions' (SFINAE)
 template<typename T> int ttest(...); // overload resolution matches always
 template<typename T> char ttest(typename T::__hasChecksumFunctions const volatile *); // preferred by overload resolution
@@ -65,6 +90,27 @@ struct UnsizedArrayAssertion {
 template<typename T>
 struct UnsizedArrayAssertion<T, true> {};
 
+template<typename T, bool OK>
+struct ImmutableAssertion {
+  enum { ABORT_ = sizeof(typename T::__modification_of_immutable_class) }; // does not exist
+  // Classes in immutableClasses() get their checksum generated only once, after construction.
+  // A non-const member function, a mutable member, or a set access from outside the class
+  // would invalidate that checksum. The failing lookup above forces the compiler to stop.
+};
+template<typename T>
+struct ImmutableAssertion<T, true> {};
+
+template<typename T, bool OK>
+struct LeafAssertion {
+  enum { ABORT_ = sizeof(typename T::__derived_from_a_leaf_class) }; // does not exist
+  // Advice calls __enter()/__leave() of leafClasses() non-virtually (see Devirtualize below).
+  // A protected class derived from a leaf would not be verified/generated through a pointer
+  // to the leaf: its checksum goes stale, and the next check "repairs" the old values back.
+  // Remove the base class from leafClasses(). The failing lookup above stops the compiler.
+};
+template<typename T>
+struct LeafAssertion<T, true> {};
+
 template<typename MemberInfo, bool STATIC>
 struct MemberDetails {
   enum { IS_PUBLIC  = (MemberInfo::prot == AC::PROT_PUBLIC),
@@ -0,0 +1,222 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+// Instrumentation build (GOP_PROFILE): the enter/leave sequence at the call sites of
+// the protected classes is recorded per thread into a compact binary trace (see below),
+// which is aggregated by gop_profile.cpp into profile.xml for the static analysis (q5.xqy).
+//
+// Trace format (native byte order), a sequence of:
+//   ProfileHeader { SITE, jpid, line, weight } + file name + '\0' + signature + '\0'
+//   ProfileHeader { CHUNK, thread, count, 0 } + count * ProfileRecord
+// The chunks of a thread are written in order.
+
+#include "GOP_GlobalConfig.h"
+
+namespace CoolChecksum {
+
+struct ProfileHeader {
+  enum { SITE = 0x53504f47, CHUNK = 0x43504f47 }; // "GOPS", "GOPC"
+  unsigned int magic;
+  unsigned int id; // SITE: join-point id, CHUNK: thread
+  unsigned int count; // SITE: line, CHUNK: number of records
+  unsigned int weight; // SITE: size of the target class [bytes]
+};
+
+struct ProfileRecord {
+  enum { ENTER = 0, LEAVE = 1 };
+  unsigned int event; // (join-point id << 1) | ENTER/LEAVE
+  unsigned int object; // lower bits of the target's address: identifies the object
+};
+
+} //CoolChecksum
+
+#if GOP_PROFILE
+
+#ifdef __unix__
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace CoolChecksum {
+
+class Profiler {
+private:
+  struct Buffer {
+    unsigned int thread;
+    unsigned int count;
+    ProfileRecord records[GOP_PROFILE_BUFFER];
+  };
+
+  struct State {
+    pthread_mutex_t mutex; // serializes the file
+    pthread_key_t key; // flushes the buffer on thread exit
+    bool initialized;
+    FILE* file;
+    unsigned int threads;
+    bool finished; // exit_process() has run: no more records
+  };
+
+  static State& state() {
+    static State s = { PTHREAD_MUTEX_INITIALIZER };
+    return s;
+  }
+
+  static Buffer*& buffer() {
+    static __thread Buffer* current; // zero-initialized
+    return current;
+  }
+
+  // caller holds the mutex
+  static FILE* file() {
+    State& s = state();
+    if(s.initialized == false) {
+      s.initialized = true;
+      const char* name = getenv("GOP_PROFILE_FILE");
+      s.file = fopen((name != 0) ? name : "gop_profile.bin", "wb");
+      pthread_key_create(&s.key, &exit_thread);
+      atexit(&exit_process);
+    }
+    return s.file;
+  }
+
+  static void flush(Buffer* current) {
+    State& s = state();
+    pthread_mutex_lock(&s.mutex);
+    FILE* out = file();
+    if((out != 0) && (current->count != 0)) {
+      ProfileHeader header = { ProfileHeader::CHUNK, current->thread, current->count, 0 };
+      fwrite(&header, sizeof(header), 1, out);
+      fwrite(current->records, sizeof(ProfileRecord), current->count, out);
+    }
+    pthread_mutex_unlock(&s.mutex);
+    current->count = 0;
+  }
+
+  // runs in the exiting thread: later destructors (of other keys or thread-locals) may still
+  // call advised functions, which must not write to the freed buffer (a new one is allocated)
+  static void exit_thread(void* arg) {
+    Buffer* current = static_cast<Buffer*>(arg);
+    flush(current);
+    buffer() = 0;
+    free(current);
+  }
+
+  // the main thread does not run the key's destructor
+  static void exit_process() {
+    State& s = state();
+    __atomic_store_n(&s.finished, true, __ATOMIC_RELAXED); // e.g., destructors of static objects
+    Buffer* current = buffer();
+    if(current != 0) {
+      flush(current);
+    }
+    pthread_mutex_lock(&s.mutex);
+    if(s.file != 0) {
+      fflush(s.file);
+    }
+    pthread_mutex_unlock(&s.mutex);
+  }
+
+  // the buffer of the calling thread, 0 if it cannot be allocated (retried on the next record),
+  // or if the process is exiting
+  static Buffer* self() {
+    if(__atomic_load_n(&state().finished, __ATOMIC_RELAXED)) {
+      return 0;
+    }
+    Buffer*& current = buffer();
+    if(current == 0) {
+      current = static_cast<Buffer*>(malloc(sizeof(Buffer)));
+      if(current == 0) {
+        return 0;
+      }
+      current->count = 0;
+      State& s = state();
+      pthread_mutex_lock(&s.mutex);
+      file();
+      current->thread = s.threads++;
+      pthread_setspecific(s.key, current);
+      pthread_mutex_unlock(&s.mutex);
+    }
+    return current;
+  }
+
+  static void site(unsigned int jpid, const char* filename, unsigned int line,
+                   const char* signature, unsigned int weight) {
+    State& s = state();
+    pthread_mutex_lock(&s.mutex);
+    FILE* out = file();
+    if(out != 0) {
+      ProfileHeader header = { ProfileHeader::SITE, jpid, line, weight };
+      fwrite(&header, sizeof(header), 1, out);
+      fwrite(filename, strlen(filename) + 1, 1, out);
+      fwrite(signature, strlen(signature) + 1, 1, out);
+    }
+    pthread_mutex_unlock(&s.mutex);
+  }
+
+  // each call site is described once
+  template<typename JoinPoint>
+  struct Site {
+    static unsigned int& described() {
+      static unsigned int flag; // zero-initialized
+      return flag;
+    }
+  };
+
+public:
+  template<typename JoinPoint>
+  __attribute__((always_inline)) inline static void record(const void* target, unsigned int event) {
+    if(__atomic_exchange_n(&Site<JoinPoint>::described(), 1, __ATOMIC_RELAXED) == 0) {
+      site(JoinPoint::JPID, JoinPoint::filename(), JoinPoint::line(),
+           JoinPoint::signature(), sizeof(typename JoinPoint::Target));
+    }
+    Buffer* current = self();
+    if(current == 0) {
+      return; // out of memory (or exiting): the record is lost, the profile is merely less complete
+    }
+    ProfileRecord& r = current->records[current->count];
+    r.event = (((unsigned int) JoinPoint::JPID) << 1) | event;
+    r.object = (unsigned int) (unsigned long) target;
+    if(++current->count == GOP_PROFILE_BUFFER) {
+      flush(current);
+    }
+  }
+};
+
+} //CoolChecksum
+
+#else /* ! __unix__ */
+
+namespace CoolChecksum {
+#warning "Profiler not implemented!"
+class Profiler {
+public:
+  template<typename JoinPoint>
+  static void record(const void* target, unsigned int event) {}
+};
+}
+
+#endif /* __unix__ */
+
+#endif /* GOP_PROFILE */
+
+#endif /* __PROFILER_H__ */
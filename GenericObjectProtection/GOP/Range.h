@@ -0,0 +1,103 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __RANGE_H__
+#define __RANGE_H__
+
+// Bulk verification and generation for arrays and containers of protected objects:
+// the checksum functions of the element type are called directly (inlined, no virtual
+// __enter()/__leave() per element), and the next elements are prefetched meanwhile.
+// The elements must be objects of exactly the element type (not of a derived class).
+//
+//   unsigned long failed = CoolChecksum::verify_range(shapes.begin(), shapes.end());
+//
+// Uncorrectable errors are not reported by the on_error() advice, but per element to the
+// optional report functor (called with the iterator), and counted by the return value.
+
+namespace CoolChecksum {
+
+struct RangeIgnore {
+  template<typename Iterator>
+  __attribute__((always_inline)) inline void operator()(const Iterator&) {}
+};
+
+template<typename Iterator>
+class RangePrefetch {
+private:
+  enum { DISTANCE = 4 }; // [elements]
+  Iterator ahead;
+  const Iterator last;
+
+  __attribute__((always_inline)) inline void prefetch() {
+    __builtin_prefetch(&*ahead, 1, 0);
+    // the checksum is not necessarily at the end of the object (base classes, aligned metadata)
+    __builtin_prefetch((*ahead).__chksum_address(), 1, 0);
+  }
+
+public:
+  __attribute__((always_inline)) inline RangePrefetch(Iterator first, Iterator end) : ahead(first), last(end) {
+    for(unsigned int i = 0; (i < DISTANCE) && (ahead != last); i++, ++ahead) {
+      prefetch();
+    }
+  }
+
+  __attribute__((always_inline)) inline void next() {
+    if(ahead != last) {
+      prefetch();
+      ++ahead;
+    }
+  }
+};
+
+// verifies (and corrects) all objects in [first, last), returns the number of objects with
+// uncorrectable errors. The lockers are not consulted: an object whose checksum is dirty
+// (being modified right now) passes unverified, all others are verified, even if in use.
+template<typename Iterator, typename Report>
+unsigned long verify_range(Iterator first, Iterator last, Report report) {
+  unsigned long failed = 0;
+  RangePrefetch<Iterator> prefetch(first, last);
+  for(; first != last; ++first) {
+    prefetch.next();
+    if((*first).__verify_exact() == false) {
+      report(first);
+      failed++;
+    }
+  }
+  return failed;
+}
+
+template<typename Iterator>
+unsigned long verify_range(Iterator first, Iterator last) {
+  return verify_range(first, last, RangeIgnore());
+}
+
+// (re-)generates the checksums of all objects in [first, last), e.g., after initializing
+// them in bulk. The objects must not be in use by other threads meanwhile.
+template<typename Iterator>
+void generate_range(Iterator first, Iterator last) {
+  RangePrefetch<Iterator> prefetch(first, last);
+  for(; first != last; ++first) {
+    prefetch.next();
+    (*first).__generate_exact();
+  }
+}
+
+} //CoolChecksum
+
+#endif /* __RANGE_H__ */
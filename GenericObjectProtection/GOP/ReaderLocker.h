@@ -0,0 +1,156 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __CHECKSUM_READER_LOCKER_H__
+#define __CHECKSUM_READER_LOCKER_H__
+
+#include "GOP_GlobalConfig.h"
+#include "Locker.h"
+
+namespace CoolChecksum {
+
+// the reader entries of one slot, written only by the threads assigned to that slot.
+// An entry packs the address of a locker (bits 63..8) and its number of readers (bits 7..0),
+// thus, a single CAS claims, counts, and releases it (intended for 64-bit targets, see
+// GOP_USE_SEQLOCK_FLAGS).
+struct ReaderSlot {
+  enum { COLUMNS = GOP_CACHE_LINE_SIZE / sizeof(unsigned long long), COUNT_BITS = 8 };
+  static const unsigned long long COUNT_MASK = (1ULL << COUNT_BITS) - 1;
+  unsigned long long entry[COLUMNS]; // lockers are mapped to a column by their address
+} __attribute__((aligned(GOP_CACHE_LINE_SIZE)));
+
+// Reader-biased locker for read-mostly objects (cf. big-reader locks and BRAVO):
+// non-const functions (writers) use the ANB-encoded counter of ChksumLocker,
+// whereas const functions (readers) increment a counter in their own slot only.
+// The entry is tagged with the locker's address, so readers are counted per object exactly:
+// a writer must never rely on the readers of another object to generate its checksum.
+// If the entry is held by another object (or its counter is saturated), the reader is
+// counted in the locker itself instead, which writes the object's cache line.
+template<bool NOT_EMPTY>
+class ChksumReaderLocker : public ChksumLocker<NOT_EMPTY> {
+  private:
+  mutable unsigned int readers; // readers not counted in a slot (see above)
+
+  static ReaderSlot* slots() {
+    static ReaderSlot table[GOP_READER_SLOTS]; // zero-initialized
+    return table;
+  }
+
+  // the calling thread's slot, assigned round-robin on first use
+  __attribute__((always_inline)) inline static ReaderSlot& my_slot() {
+    static __thread unsigned int slot; // index + 1, zero means 'not yet assigned'
+    if(__builtin_expect(slot == 0, 0)) {
+      static unsigned int next_slot;
+      slot = (__atomic_fetch_add(&next_slot, 1, __ATOMIC_RELAXED) % GOP_READER_SLOTS) + 1;
+    }
+    return slots()[slot - 1];
+  }
+
+  __attribute__((always_inline)) inline unsigned int column() const {
+    unsigned long key = (unsigned long) this / sizeof(void*);
+    key ^= key >> 7;
+    return key % ReaderSlot::COLUMNS;
+  }
+
+  __attribute__((always_inline)) inline unsigned long long tag() const {
+    return ((unsigned long long) (unsigned long) this) << ReaderSlot::COUNT_BITS;
+  }
+
+  public:
+  inline ChksumReaderLocker() : readers(0) {}
+  inline ChksumReaderLocker(const ChksumReaderLocker& other) : ChksumLocker<NOT_EMPTY>(other), readers(0) {} // see ChksumLocker
+  __attribute__((always_inline)) inline ChksumReaderLocker& operator=(const ChksumReaderLocker&) { return *this; }
+
+  // register as reader and return 'true' when there is no writer (cf. __is_unlocked()).
+  // Both are sequentially consistent: a concurrent writer either sees this reader
+  // in __has_readers(), or this reader sees the writer.
+  __attribute__((always_inline)) inline bool __read_lock() const {
+    unsigned long long* const entry = &my_slot().entry[column()];
+    unsigned long long reg_entry = __atomic_load_n(entry, __ATOMIC_RELAXED);
+    for(;;) {
+      unsigned long long next;
+      if(reg_entry == 0) {
+        next = tag() | 1; // claim the free entry
+      }
+      else if(((reg_entry & ~ReaderSlot::COUNT_MASK) == tag()) &&
+              ((reg_entry & ReaderSlot::COUNT_MASK) != ReaderSlot::COUNT_MASK)) {
+        next = reg_entry + 1;
+      }
+      else {
+        __atomic_fetch_add(&readers, 1, __ATOMIC_SEQ_CST); // held by another object
+        break;
+      }
+      if(__atomic_compare_exchange_n(entry, &reg_entry, next, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        break;
+      }
+    }
+    const unsigned int reg_lock = __atomic_load_n(&(this->lock), __ATOMIC_SEQ_CST);
+    if(reg_lock == ChksumLocker<NOT_EMPTY>::B_CONSTANT) {
+      return true; // valid code word => no __check()'ing
+    }
+    ChksumLocker<NOT_EMPTY>::__check(reg_lock); // check for (possible) bit errors in the locker
+    return false;
+  }
+
+  // Another reader of this object in the same slot may have taken over the entry meanwhile:
+  // decrementing either counter keeps the sum exact, and neither can underflow, since the
+  // readers of a slot register and unregister only in their slot's entry or in 'readers'.
+  __attribute__((always_inline)) inline void __read_unlock() const {
+    unsigned long long* const entry = &my_slot().entry[column()];
+    unsigned long long reg_entry = __atomic_load_n(entry, __ATOMIC_RELAXED);
+    for(;;) {
+      if((reg_entry & ~ReaderSlot::COUNT_MASK) != tag() || (reg_entry & ReaderSlot::COUNT_MASK) == 0) {
+        __atomic_fetch_sub(&readers, 1, __ATOMIC_SEQ_CST);
+        return;
+      }
+      const unsigned long long next = ((reg_entry & ReaderSlot::COUNT_MASK) == 1) ? 0 : (reg_entry - 1); // release
+      if(__atomic_compare_exchange_n(entry, &reg_entry, next, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+        return;
+      }
+    }
+  }
+
+  // scan all slots (loads only), stop at the first reader of this object found
+  __attribute__((always_inline)) inline bool __has_readers() const {
+    __atomic_thread_fence(__ATOMIC_SEQ_CST); // order the preceding locker update before the scan
+    if(__atomic_load_n(&readers, __ATOMIC_RELAXED) != 0) {
+      return true;
+    }
+    const unsigned int col = column();
+    const ReaderSlot* const table = slots();
+    for(unsigned int i = 0; i < GOP_READER_SLOTS; i++) {
+      const unsigned long long reg_entry = __atomic_load_n(&table[i].entry[col], __ATOMIC_RELAXED);
+      if(((reg_entry & ~ReaderSlot::COUNT_MASK) == tag()) && ((reg_entry & ReaderSlot::COUNT_MASK) != 0)) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+template<>
+class ChksumReaderLocker<false> : public ChksumLocker<false> {
+public:
+  __attribute__((always_inline)) inline bool __read_lock() const { return false; }
+  __attribute__((always_inline)) inline void __read_unlock() const {}
+};
+
+} //CoolChecksum
+
+#endif /* __CHECKSUM_READER_LOCKER_H__ */
@@ -0,0 +1,264 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __REGISTRY_H__
+#define __REGISTRY_H__
+
+#include "GOP_GlobalConfig.h"
+
+namespace CoolChecksum {
+
+// Intrusive registry of all live objects of the registeredClasses() (see ChecksumIntroducer.ah):
+// the foundation for scrubbing, statistics and bulk operations on objects that are idle otherwise.
+// Each class has its own list, sharded by the objects' addresses. Linking and unlinking is O(1),
+// and serialized per shard only (no global lock). A visitor holds the shard only while advancing
+// to the next object, and marks the object it visits: unlinking that object (i.e., its destruction)
+// waits until the visit is done, whereas all other objects of the shard come and go meanwhile.
+
+// the link woven into each registered object: copying an object must not copy its links
+class RegistryNode {
+  RegistryNode* prev;
+  RegistryNode* next;
+  unsigned int visiting; // set and reset with the shard held, see RegistryCursor
+
+  friend struct RegistryShard;
+  friend class RegistryCursor;
+public:
+  RegistryNode() : prev(0), next(0), visiting(0) {}
+  RegistryNode(const RegistryNode&) : prev(0), next(0), visiting(0) {}
+  RegistryNode& operator=(const RegistryNode&) { return *this; }
+};
+
+// a doubly-linked list guarded by a spinlock, one cache line per shard
+// (a POD, zero-initialized: usable before any constructor has run)
+struct RegistryShard {
+  mutable unsigned int lock;
+  unsigned int objects; // number of linked objects
+  RegistryNode* first;
+
+  __attribute__((always_inline)) inline void acquire() const {
+    while(__atomic_exchange_n(&lock, 1, __ATOMIC_ACQUIRE) != 0) {
+      while(__atomic_load_n(&lock, __ATOMIC_RELAXED) != 0) {} // spin read-only
+    }
+  }
+  __attribute__((always_inline)) inline void release() const {
+    __atomic_store_n(&lock, 0, __ATOMIC_RELEASE);
+  }
+
+  __attribute__((always_inline)) inline void link(RegistryNode* node) {
+    acquire();
+    node->prev = 0;
+    node->next = first;
+    if(first != 0) {
+      first->prev = node;
+    }
+    first = node;
+    objects++;
+    release();
+  }
+
+  __attribute__((always_inline)) inline void unlink(RegistryNode* node) {
+    acquire();
+    while(__atomic_load_n(&node->visiting, __ATOMIC_ACQUIRE) != 0) { // rare: wait until the visit is done
+      release();
+      while(__atomic_load_n(&node->visiting, __ATOMIC_ACQUIRE) != 0) {} // spin read-only
+      acquire();
+    }
+    if(node->prev != 0) {
+      node->prev->next = node->next;
+    }
+    else {
+      first = node->next;
+    }
+    if(node->next != 0) {
+      node->next->prev = node->prev;
+    }
+    node->prev = 0;
+    node->next = 0;
+    objects--;
+    release();
+  }
+
+  __attribute__((always_inline)) inline unsigned int size() const { return __atomic_load_n(&objects, __ATOMIC_RELAXED); }
+
+  friend class RegistryCursor;
+} __attribute__((aligned(GOP_CACHE_LINE_SIZE)));
+
+// iterates over a shard, with the shard held only while advancing. The current node is marked
+// as being visited, so that it stays linked (and alive) until the cursor moves on, or is
+// destroyed: a visitor that throws does not leave the mark (or the shard) behind.
+class RegistryCursor {
+  RegistryShard& shard;
+  RegistryNode* node; // the marked node
+  RegistryNode* ahead; // the node after it, when advancing (for prefetching only)
+  bool started;
+
+  RegistryCursor(const RegistryCursor&);
+  RegistryCursor& operator=(const RegistryCursor&);
+
+public:
+  RegistryCursor(RegistryShard& s) : shard(s), node(0), ahead(0), started(false) {}
+  ~RegistryCursor() {
+    if(node != 0) {
+      shard.acquire();
+      __atomic_store_n(&node->visiting, 0, __ATOMIC_RELEASE);
+      shard.release();
+    }
+  }
+
+  // unmark the current node, mark and return the next one (0 at the end)
+  RegistryNode* advance() {
+    shard.acquire();
+    RegistryNode* const following = started ? node->next : shard.first;
+    if(node != 0) {
+      __atomic_store_n(&node->visiting, 0, __ATOMIC_RELEASE);
+    }
+    if(following != 0) {
+      __atomic_store_n(&following->visiting, 1, __ATOMIC_RELAXED);
+      ahead = following->next;
+    }
+    else {
+      ahead = 0;
+    }
+    shard.release();
+    started = true;
+    node = following;
+    return node;
+  }
+
+  // may be unlinked (and destroyed) already: use as a hint, only
+  __attribute__((always_inline)) inline RegistryNode* peek() const { return ahead; }
+};
+
+// the objects of one registered class (constant-initialized, see Registry<T>::self())
+struct ClassRegistry {
+  RegistryShard shards[GOP_REGISTRY_SHARDS];
+  ClassRegistry* next; // the list of all registered classes (see ClassRegistry::first())
+  unsigned int listed; // already linked into that list?
+  unsigned long size; // sizeof(T) [bytes]
+  unsigned long offset; // of the RegistryNode within T (set when listed)
+  bool (*scrub)(void* obj); // verify an object in the background (see Scrubber.h)
+
+  // the object a node is woven into
+  __attribute__((always_inline)) inline void* object(RegistryNode* node) const {
+    return ((char*) node) - offset;
+  }
+
+  __attribute__((always_inline)) inline static RegistryShard& shard(ClassRegistry& registry, const void* addr) {
+    unsigned long key = (unsigned long) addr / GOP_CACHE_LINE_SIZE; // same hash as StopPreemption.h
+    key ^= key >> 7;
+    key ^= key >> 13;
+    return registry.shards[key % GOP_REGISTRY_SHARDS];
+  }
+
+  // the head of the list of all classes that have registered objects (pushed lock-free, never removed)
+  __attribute__((always_inline)) inline static ClassRegistry*& first() {
+    static ClassRegistry* head; // zero-initialized
+    return head;
+  }
+
+  static void list(ClassRegistry* registry, unsigned long offset) {
+    unsigned int expected = 0;
+    if(__atomic_compare_exchange_n(&registry->listed, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+      registry->offset = offset; // published by the push below
+      ClassRegistry* head = __atomic_load_n(&first(), __ATOMIC_ACQUIRE);
+      do {
+        registry->next = head;
+      } while(!__atomic_compare_exchange_n(&first(), &head, registry, true, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE));
+    }
+  }
+
+  // calls visitor(registry, obj) for all objects of the shard (see RegistryCursor): the shard is
+  // held for O(1) per object, thus, constructing/destructing other objects does not wait for the walk.
+  // The first and the last cache line of the next object (payload, and the appended
+  // __chksum/__locker) are prefetched while visiting the current one.
+  template<typename Visitor>
+  void visit(unsigned int s, Visitor& visitor) {
+    RegistryCursor cursor(shards[s]);
+    for(RegistryNode* node = cursor.advance(); node != 0; node = cursor.advance()) {
+      if(cursor.peek() != 0) {
+        const char* obj = static_cast<const char*>(object(cursor.peek())); // prefetching never faults
+        __builtin_prefetch(obj, 0, 0);
+        __builtin_prefetch(obj + size - 1, 0, 0);
+      }
+      visitor(*this, object(node));
+    }
+  }
+
+  template<typename Visitor>
+  void visit(Visitor& visitor) {
+    for(unsigned int s = 0; s < GOP_REGISTRY_SHARDS; s++) {
+      visit(s, visitor);
+    }
+  }
+
+  // all objects of all registered classes
+  template<typename Visitor>
+  static void visit_all(Visitor& visitor) {
+    for(ClassRegistry* registry = __atomic_load_n(&first(), __ATOMIC_ACQUIRE); registry != 0; registry = registry->next) {
+      registry->visit(visitor);
+    }
+  }
+
+  unsigned long objects() const {
+    unsigned long result = 0;
+    for(unsigned int s = 0; s < GOP_REGISTRY_SHARDS; s++) {
+      result += shards[s].size();
+    }
+    return result;
+  }
+};
+
+// only synchronizedClasses() can be verified while other threads use them
+template<typename T, int SYNCHRONIZED=T::SYNCHRONIZED>
+struct Scrub {
+  static bool exec(void* obj) { return static_cast<T*>(obj)->__scrub(); }
+};
+template<typename T>
+struct Scrub<T, 0> {
+  static bool exec(void* obj) { return true; }
+};
+
+// linking/unlinking, used by the construction/destruction advice (see ChecksumAdviceInvoker.ah)
+template<typename T>
+class Registry {
+  __attribute__((always_inline)) inline static RegistryNode* node(T* obj) { return &(obj->__registry_node); }
+
+public:
+  __attribute__((always_inline)) inline static ClassRegistry& self() {
+    // constant-initialized: objects constructed during static initialization can register, too
+    static ClassRegistry registry = { {}, 0, 0, sizeof(T), 0, &Scrub<T>::exec };
+    return registry;
+  }
+
+  __attribute__((always_inline)) inline static void add(T* obj) {
+    ClassRegistry& registry = self();
+    ClassRegistry::shard(registry, obj).link(node(obj));
+    if(__atomic_load_n(&registry.listed, __ATOMIC_RELAXED) == 0) {
+      ClassRegistry::list(&registry, ((char*) node(obj)) - ((char*) obj)); // once per class
+    }
+  }
+
+  __attribute__((always_inline)) inline static void remove(T* obj) {
+    ClassRegistry::shard(self(), obj).unlink(node(obj));
+  }
+};
+
+} //CoolChecksum
+
+#endif /* __REGISTRY_H__ */
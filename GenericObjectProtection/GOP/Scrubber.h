@@ -0,0 +1,334 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __SCRUBBER_H__
+#define __SCRUBBER_H__
+
+// A background thread that verifies all objects of the registeredClasses() (see Registry.h),
+// so that idle objects are corrected before a second bit flip makes the error uncorrectable.
+// Objects in use are skipped (see __scrub() in ChecksumSlice.ah), and uncorrectable errors
+// are reported by the usual on_error() advice (see GOP_Common.ah).
+// For large heaps, several workers share a pass: the shards are split among them, and
+// idle workers steal the remaining shards of the others (see GOP_SCRUB_WORKERS).
+
+#include "GOP_GlobalConfig.h"
+#include "Registry.h"
+
+#ifdef __unix__
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+namespace CoolChecksum {
+
+class Scrubber {
+private:
+  enum { IDLE_NS = 10 * 1000 * 1000, // pause if there is nothing to scrub
+         SLEEP_NS = 10 * 1000 * 1000 }; // longest sleep between two checks for stop()
+
+  // the (class, shard) pairs of a pass are split into one contiguous range per worker.
+  // A worker that has finished its own range steals from the others' ranges.
+  struct Range {
+    unsigned long cursor; // next item (advanced by the owner and by thieves)
+    unsigned long end;
+  } __attribute__((aligned(GOP_CACHE_LINE_SIZE)));
+
+  struct State {
+    pthread_t threads[GOP_SCRUB_MAX_WORKERS];
+    pthread_barrier_t barrier; // begin and end of each pass
+    unsigned int ready; // the barrier has been initialized
+    unsigned int running;
+    unsigned int workers;
+    unsigned long bytes_per_second; // 0: unlimited (shared by all workers)
+    int cpu; // -1: not pinned, otherwise the first CPU (worker i runs on cpu + i)
+    int priority; // see GOP_SCRUB_PRIORITY
+    // the current pass (written by worker 0 between the barriers)
+    bool quit;
+    ClassRegistry* head;
+    unsigned long long start;
+    Range ranges[GOP_SCRUB_MAX_WORKERS];
+    unsigned long pass_objects;
+    // statistics
+    unsigned long passes; // completed passes over all registered objects
+    unsigned long objects; // verified objects (in total)
+    unsigned long uncorrectable; // objects with uncorrectable errors (in total)
+    unsigned long long sweep_ns; // duration of the last pass
+    unsigned long sweep_objects; // verified objects of the last pass
+  };
+
+  static State& state() {
+    static State s; // zero-initialized
+    return s;
+  }
+
+  struct Visitor {
+    unsigned long bytes;
+    unsigned long objects;
+    unsigned long uncorrectable;
+    void operator()(ClassRegistry& registry, void* obj) {
+      if(registry.scrub(obj) == false) {
+        uncorrectable++;
+      }
+      bytes += registry.size;
+      objects++;
+    }
+  };
+
+  static unsigned long long now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((unsigned long long) ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+  }
+
+  static bool running() {
+    return (__atomic_load_n(&state().running, __ATOMIC_ACQUIRE) != 0);
+  }
+
+  static void sleep(unsigned long long ns) {
+    while((ns > 0) && running()) {
+      const unsigned long long slice = (ns < SLEEP_NS) ? ns : (unsigned long long) SLEEP_NS;
+      struct timespec ts = { (time_t) (slice / 1000000000ULL), (long) (slice % 1000000000ULL) };
+      nanosleep(&ts, 0);
+      ns -= slice;
+    }
+  }
+
+  // keep the average rate of the current pass within the budget
+  static void throttle(unsigned long long start, unsigned long bytes, unsigned long bytes_per_second) {
+    if(bytes_per_second == 0) {
+      return; // unlimited
+    }
+    const unsigned long long due = start + (((unsigned long long) bytes) * 1000000000ULL) / bytes_per_second;
+    const unsigned long long current = now();
+    if(due > current) {
+      sleep(due - current);
+    }
+  }
+
+  static void record(unsigned long long start, const Visitor& visitor) {
+    State& s = state();
+    __atomic_store_n(&s.sweep_ns, now() - start, __ATOMIC_RELAXED);
+    __atomic_store_n(&s.sweep_objects, visitor.objects, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s.passes, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s.objects, visitor.objects, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s.uncorrectable, visitor.uncorrectable, __ATOMIC_RELAXED);
+  }
+
+  // the registry of the item's class: the list only grows at its head, so the classes
+  // behind the snapshot taken at the beginning of the pass keep their positions
+  static ClassRegistry* lookup(unsigned long index, unsigned long& cached_index, ClassRegistry*& cached) {
+    if((cached == 0) || (index < cached_index)) {
+      cached = state().head;
+      cached_index = 0;
+    }
+    while(cached_index < index) {
+      cached = cached->next;
+      cached_index++;
+    }
+    return cached;
+  }
+
+  // worker 0 only: set up the next pass
+  static void prepare() {
+    State& s = state();
+    s.quit = !running();
+    s.head = __atomic_load_n(&ClassRegistry::first(), __ATOMIC_ACQUIRE);
+    unsigned long classes = 0;
+    for(ClassRegistry* registry = s.head; registry != 0; registry = registry->next) {
+      classes++;
+    }
+    const unsigned long items = classes * GOP_REGISTRY_SHARDS;
+    for(unsigned int w = 0; w < s.workers; w++) {
+      s.ranges[w].cursor = (items * w) / s.workers;
+      s.ranges[w].end = (items * (w + 1)) / s.workers;
+    }
+    s.pass_objects = 0;
+    s.start = now();
+  }
+
+  // all workers: the own range first, then steal from the others
+  static void sweep(unsigned int id) {
+    State& s = state();
+    Visitor visitor = { 0, 0, 0 };
+    unsigned long budget = s.bytes_per_second / s.workers;
+    if((budget == 0) && (s.bytes_per_second != 0)) {
+      budget = 1; // a rate below one byte per second and worker, not 'unlimited'
+    }
+    unsigned long cached_index = 0;
+    ClassRegistry* cached = 0;
+    for(unsigned int k = 0; (k < s.workers) && running(); k++) {
+      Range& range = s.ranges[(id + k) % s.workers];
+      unsigned long item;
+      while(((item = __atomic_fetch_add(&range.cursor, 1, __ATOMIC_RELAXED)) < range.end) && running()) {
+        lookup(item / GOP_REGISTRY_SHARDS, cached_index, cached)->visit(item % GOP_REGISTRY_SHARDS, visitor);
+        throttle(s.start, visitor.bytes, budget);
+        if(s.priority > 0) {
+          sched_yield(); // let the application threads go first
+        }
+      }
+    }
+    __atomic_add_fetch(&s.pass_objects, visitor.objects, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s.objects, visitor.objects, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&s.uncorrectable, visitor.uncorrectable, __ATOMIC_RELAXED);
+  }
+
+  static void setup(unsigned int id) {
+    State& s = state();
+    if(s.cpu >= 0) {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET(s.cpu + id, &cpus);
+      pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+#ifdef SCHED_IDLE
+    if(s.priority > 0) {
+      struct sched_param param = { 0 };
+      pthread_setschedparam(pthread_self(), (s.priority > 1) ? SCHED_IDLE : SCHED_BATCH, &param);
+    }
+#endif
+  }
+
+  static void cleanup() {
+    State& s = state();
+    for(unsigned int w = 0; w < s.workers; w++) {
+      pthread_join(s.threads[w], 0);
+    }
+    if(s.workers != 0) {
+      pthread_barrier_destroy(&s.barrier);
+    }
+    s.workers = 0;
+    __atomic_store_n(&s.ready, 0, __ATOMIC_RELEASE);
+  }
+
+  static void* run(void* arg) {
+    State& s = state();
+    const unsigned int id = (unsigned int) (unsigned long) arg;
+    while(__atomic_load_n(&s.ready, __ATOMIC_ACQUIRE) == 0) {
+      sched_yield(); // wait until all workers have been created
+    }
+    setup(id);
+    while(true) {
+      if(id == 0) {
+        prepare();
+      }
+      pthread_barrier_wait(&s.barrier);
+      if(s.quit) {
+        break; // decided by worker 0 for all workers
+      }
+      sweep(id);
+      pthread_barrier_wait(&s.barrier);
+      if(id == 0) {
+        const unsigned long objects = __atomic_load_n(&s.pass_objects, __ATOMIC_RELAXED);
+        __atomic_store_n(&s.sweep_ns, now() - s.start, __ATOMIC_RELAXED);
+        __atomic_store_n(&s.sweep_objects, objects, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&s.passes, 1, __ATOMIC_RELAXED);
+        if(objects == 0) {
+          sleep(IDLE_NS); // no registered objects (yet)
+        }
+      }
+    }
+    return 0;
+  }
+
+public:
+  // start the scrubber threads (once): the budget of bytes per second is shared by all workers
+  static bool start(unsigned long bytes_per_second = GOP_SCRUB_BYTES_PER_SECOND, int cpu = GOP_SCRUB_CPU,
+                    unsigned int workers = GOP_SCRUB_WORKERS, int priority = GOP_SCRUB_PRIORITY) {
+    State& s = state();
+    if((workers == 0) || (workers > GOP_SCRUB_MAX_WORKERS)) {
+      return false;
+    }
+    unsigned int expected = 0;
+    if(__atomic_compare_exchange_n(&s.running, &expected, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) == false) {
+      return false; // already running
+    }
+    s.bytes_per_second = bytes_per_second;
+    s.cpu = cpu;
+    s.priority = priority;
+    s.workers = 0;
+    while((s.workers < workers) && (pthread_create(&s.threads[s.workers], 0, &run, (void*) (unsigned long) s.workers) == 0)) {
+      s.workers++;
+    }
+    const bool success = (s.workers == workers);
+    if(success == false) {
+      __atomic_store_n(&s.running, 0, __ATOMIC_RELEASE); // the created workers quit in their first pass
+    }
+    if(s.workers != 0) {
+      pthread_barrier_init(&s.barrier, 0, s.workers);
+    }
+    __atomic_store_n(&s.ready, 1, __ATOMIC_RELEASE);
+    if(success == false) {
+      cleanup();
+    }
+    return success;
+  }
+
+  // stop the scrubber threads, and wait for them
+  static void stop() {
+    State& s = state();
+    if(__atomic_exchange_n(&s.running, 0, __ATOMIC_ACQ_REL) != 0) {
+      cleanup();
+    }
+  }
+
+  // a single pass over all registered objects in the calling thread (without the workers),
+  // shard by shard: no shard is held while sleeping. Returns the number of visited objects.
+  static unsigned long pass(unsigned long bytes_per_second = 0) {
+    Visitor visitor = { 0, 0, 0 };
+    const unsigned long long start = now();
+    for(ClassRegistry* registry = __atomic_load_n(&ClassRegistry::first(), __ATOMIC_ACQUIRE);
+        registry != 0; registry = registry->next) {
+      for(unsigned int shard = 0; shard < GOP_REGISTRY_SHARDS; shard++) {
+        registry->visit(shard, visitor);
+        throttle(start, visitor.bytes, bytes_per_second);
+      }
+    }
+    record(start, visitor);
+    return visitor.objects;
+  }
+
+  // statistics
+  static unsigned long passes() { return __atomic_load_n(&state().passes, __ATOMIC_RELAXED); }
+  static unsigned long objects() { return __atomic_load_n(&state().objects, __ATOMIC_RELAXED); }
+  static unsigned long uncorrectable() { return __atomic_load_n(&state().uncorrectable, __ATOMIC_RELAXED); }
+  // the time for a full sweep over all registered objects, and the resulting throughput (of the last pass)
+  static unsigned long long sweep_time_ns() { return __atomic_load_n(&state().sweep_ns, __ATOMIC_RELAXED); }
+  static unsigned long objects_per_second() {
+    const unsigned long long ns = sweep_time_ns();
+    const unsigned long objects = __atomic_load_n(&state().sweep_objects, __ATOMIC_RELAXED);
+    return (ns == 0) ? 0 : (unsigned long) ((((unsigned long long) objects) * 1000000000ULL) / ns);
+  }
+};
+
+} //CoolChecksum
+
+#else /* ! __unix__ */
+
+namespace CoolChecksum {
+#warning "Scrubber not implemented!"
+class Scrubber {
+public:
+  static bool start(unsigned long bytes_per_second = GOP_SCRUB_BYTES_PER_SECOND, int cpu = GOP_SCRUB_CPU,
+                    unsigned int workers = GOP_SCRUB_WORKERS, int priority = GOP_SCRUB_PRIORITY) { return false; }
+  static void stop() {}
+};
+}
+
+#endif /* __unix__ */
+
+#endif /* __SCRUBBER_H__ */
@@ -0,0 +1,136 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __SESSION_H__
+#define __SESSION_H__
+
+#include "GOP_GlobalConfig.h"
+#include "TypeTraits.h"
+
+namespace CoolChecksum {
+
+#if GOP_SESSION_STACK_SIZE
+
+// The objects the calling thread has opened a Session for. Calls to (and get/set
+// accesses of) these objects are not advised (see ChecksumAdviceInvoker.ah).
+class SessionStack {
+private:
+  const void* object[GOP_SESSION_STACK_SIZE];
+  bool writable[GOP_SESSION_STACK_SIZE]; // non-const session
+  unsigned int top;
+
+  __attribute__((always_inline)) inline static SessionStack& self() {
+    static __thread SessionStack stack; // zero-initialized
+    return stack;
+  }
+
+public:
+  __attribute__((always_inline)) inline static bool empty() { return (self().top == 0); }
+
+  // returns 'false' if there is no room left: the session's object is advised as usual, then
+  __attribute__((always_inline)) inline static bool push(const void* id, bool write) {
+    SessionStack& stack = self();
+    if(stack.top < GOP_SESSION_STACK_SIZE) {
+      stack.object[stack.top] = id;
+      stack.writable[stack.top] = write;
+      stack.top++;
+      return true;
+    }
+    return false;
+  }
+
+  // sessions are scoped, hence the last one pushed is popped
+  __attribute__((always_inline)) inline static void pop() { self().top--; }
+
+  // a non-const call needs a non-const session, a const call any session
+  __attribute__((always_inline)) inline static bool contains(const void* id, bool write) {
+    SessionStack& stack = self();
+    for(unsigned int i = stack.top; i > 0; i--) {
+      if( (stack.object[i-1] == id) && (stack.writable[i-1] || (write == false)) ) {
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+#else /* ! GOP_SESSION_STACK_SIZE */
+
+class SessionStack {
+public:
+  __attribute__((always_inline)) inline static bool empty() { return true; }
+  __attribute__((always_inline)) inline static bool push(const void* id, bool write) { return false; }
+  __attribute__((always_inline)) inline static void pop() {}
+  __attribute__((always_inline)) inline static bool contains(const void* id, bool write) { return false; }
+};
+
+#endif /* GOP_SESSION_STACK_SIZE */
+
+// the complete object: a call through a base class pointer has to find the session, too
+template<typename T, int INHERITANCE=T::INHERITANCE>
+struct SessionId {
+  __attribute__((always_inline)) inline static const void* get(const T* obj) { return dynamic_cast<const void*>(obj); }
+};
+template<typename T>
+struct SessionId<T, 0> {
+  __attribute__((always_inline)) inline static const void* get(const T* obj) { return obj; }
+};
+
+template<typename T>
+__attribute__((always_inline)) inline bool InSession(const T* obj, bool write) {
+  if(SessionStack::empty()) {
+    return false; // fast path: no sessions on this thread
+  }
+  return SessionStack::contains(SessionId<T>::get(obj), write);
+}
+
+// Enters the object once, and leaves it (i.e., generates its checksum) once on destruction.
+// In between, calls by this thread to the object's member functions are not advised:
+//   {
+//     CoolChecksum::Session<Point> session(point);
+//     for(int i = 0; i < n; i++) { point.setX(i); }
+//   }
+// A const session (Session<const T>) covers the const member functions, only.
+// The object must not be destroyed within its session.
+template<typename T>
+class Session {
+private:
+  T& obj;
+  bool listed;
+
+  Session(const Session&); // not copyable
+  Session& operator=(const Session&);
+
+public:
+  explicit Session(T& object) : obj(object) {
+    obj.__enter(); // uncorrectable errors are reported by the on_error() advice
+    listed = SessionStack::push(SessionId<typename RemoveConst<T>::Type>::get(&obj), is_const<T>::IS_CONST == 0);
+  }
+
+  ~Session() {
+    if(listed) {
+      SessionStack::pop();
+    }
+    obj.__leave();
+  }
+};
+
+} //CoolChecksum
+
+#endif /* __SESSION_H__ */
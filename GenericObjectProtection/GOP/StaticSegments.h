@@ -0,0 +1,259 @@
+/*
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __STATIC_SEGMENTS_H__
+#define __STATIC_SEGMENTS_H__
+
+#include "GOP_GlobalConfig.h"
+#include "ObjectSize.h"
+#include "JPTL.h"
+#include "WholeObject.h"
+#include "Checksumming.h"
+
+
+namespace CoolChecksum {
+
+// GOP_USE_STATIC_SEGMENTS: the static members of a class are protected by one checksum per segment,
+// instead of a single checksum. A segment is a static member, or a block of GOP_STATIC_SEGMENT_SIZE
+// bytes of a larger member (e.g., a lookup table). Each segment is an instance of the Checksumming
+// variant on its own (flags included), thus, a get access from outside the class verifies only the
+// segment that contains the accessed address (see __static_check_get(member) in StaticChecksumSlice.ah).
+// StaticSegments provides the interface of a single static checksum for all other purposes
+// (__check, __generate, __dirty, ...), which visit all segments of the class.
+
+
+// the segments of the static member I (none, if not checksummed)
+template<typename TypeInfo, unsigned I>
+struct StaticMemberSegments {
+  typedef typename TypeInfo::template Member<I> MemberInfo;
+  enum { SIZE = SizeOfChecksummed<MemberInfo, true>::SIZE,
+         BLOCKS = (SIZE + GOP_STATIC_SEGMENT_SIZE - 1) / GOP_STATIC_SEGMENT_SIZE };
+};
+
+// a member that fits into a single segment keeps its type, blocks are unsigned char arrays
+template<typename MemberInfo, unsigned SIZE, bool SPLIT>
+struct StaticSegmentType {
+  typedef typename MemberInfo::Type Type;
+};
+template<typename MemberInfo, unsigned SIZE>
+struct StaticSegmentType<MemberInfo, SIZE, true> {
+  typedef unsigned char Type[SIZE];
+};
+
+template<typename TypeInfo, unsigned I, unsigned B> struct StaticSegment;
+
+// pseudo member info, describing the block B of the static member I
+template<typename TypeInfo, unsigned I, unsigned B>
+struct StaticSegmentMember {
+  typedef StaticMemberSegments<TypeInfo, I> SEGMENTS;
+  typedef typename SEGMENTS::MemberInfo WholeMember;
+  enum { OFFSET = B * GOP_STATIC_SEGMENT_SIZE,
+         SIZE = ((SEGMENTS::SIZE - OFFSET) < GOP_STATIC_SEGMENT_SIZE) ? (SEGMENTS::SIZE - OFFSET) : GOP_STATIC_SEGMENT_SIZE };
+  typedef typename StaticSegmentType<WholeMember, SIZE, (SEGMENTS::BLOCKS > 1)>::Type Type;
+  typedef Type ReferredType;
+  static const AC::Protection prot = WholeMember::prot;
+  static const AC::Specifiers spec = WholeMember::spec;
+  __attribute__((always_inline)) inline static ReferredType* pointer(const StaticSegment<TypeInfo, I, B>* obj = 0) {
+    return (ReferredType*) ((char*) WholeMember::pointer((typename TypeInfo::That*) 0) + OFFSET);
+  }
+  static const char* name() { return WholeMember::name(); }
+};
+
+// pseudo type info of a single segment
+template<typename TypeInfo, unsigned I, unsigned B>
+struct StaticSegmentInfo {
+  typedef StaticSegment<TypeInfo, I, B> That;
+  enum { MEMBERS = 1, BASECLASSES = 0, HASHCODE = TypeInfo::HASHCODE };
+  static const char* signature() { return TypeInfo::signature(); }
+  template<int J> struct Member : public StaticSegmentMember<TypeInfo, I, B> {}; // J == 0
+};
+
+// holds the static checksum of a segment (see Get<T, true> in ChecksummingBase.h)
+template<typename TypeInfo, unsigned I, unsigned B>
+struct StaticSegment {
+  enum { SYNCHRONIZED = TypeInfo::That::SYNCHRONIZED, INHERITANCE = TypeInfo::That::INHERITANCE };
+  typedef Checksumming<StaticSegmentInfo<TypeInfo, I, B>, true> __static_chksum_t;
+  static __static_chksum_t __static_chksum; // generated on startup, like the class's own static checksum
+};
+template<typename TypeInfo, unsigned I, unsigned B>
+typename StaticSegment<TypeInfo, I, B>::__static_chksum_t StaticSegment<TypeInfo, I, B>::__static_chksum;
+
+
+// the segments [B, BLOCKS) of the static member I
+template<typename TypeInfo, unsigned I, unsigned B=0, unsigned BLOCKS=StaticMemberSegments<TypeInfo, I>::BLOCKS>
+struct StaticBlocks {
+  typedef StaticSegment<TypeInfo, I, B> SEGMENT;
+  typedef StaticBlocks<TypeInfo, I, B+1, BLOCKS> NEXT;
+
+  __attribute__((always_inline)) inline static bool check() {
+    if(SEGMENT::__static_chksum.__check(0) == false) {
+      return false; // fail-stop
+    }
+    return NEXT::check();
+  }
+  __attribute__((always_inline)) inline static void generate() {
+    SEGMENT::__static_chksum.__generate(0);
+    NEXT::generate();
+  }
+  __attribute__((always_inline)) inline static void update(const void* member) {
+    SEGMENT::__static_chksum_t::__update(0, member);
+    NEXT::update(member);
+  }
+  __attribute__((always_inline)) inline static void commit() {
+    SEGMENT::__static_chksum_t::__commit(0);
+    NEXT::commit();
+  }
+  __attribute__((always_inline)) inline static void dirty() {
+    SEGMENT::__static_chksum.__dirty();
+    NEXT::dirty();
+  }
+  __attribute__((always_inline)) inline static const void* get_dirty() {
+    return SEGMENT::__static_chksum.get_dirty();
+  }
+  // verify the segment containing 'member', only
+  __attribute__((always_inline)) inline static bool check_segment(const void* member, bool* found) {
+    typedef StaticSegmentMember<TypeInfo, I, B> MEMBER;
+    if(MemberContains<MEMBER, MEMBER::SIZE>((SEGMENT*) 0, member)) {
+      *found = true;
+      if(SEGMENT::__static_chksum.get_dirty() != 0) {
+        return true; // already in use
+      }
+      return SEGMENT::__static_chksum.__check(0);
+    }
+    return NEXT::check_segment(member, found);
+  }
+};
+
+template<typename TypeInfo, unsigned I, unsigned BLOCKS>
+struct StaticBlocks<TypeInfo, I, BLOCKS, BLOCKS> {
+  __attribute__((always_inline)) inline static bool check() { return true; }
+  __attribute__((always_inline)) inline static void generate() {}
+  __attribute__((always_inline)) inline static void update(const void* member) {}
+  __attribute__((always_inline)) inline static void commit() {}
+  __attribute__((always_inline)) inline static void dirty() {}
+  __attribute__((always_inline)) inline static const void* get_dirty() { return 0; }
+  __attribute__((always_inline)) inline static bool check_segment(const void* member, bool* found) { return true; }
+};
+
+
+#ifndef __acweaving
+
+// the segments of the static members [0, I)
+template<typename TypeInfo, unsigned I=TypeInfo::MEMBERS>
+struct StaticMembers {
+  typedef StaticBlocks<TypeInfo, I-1> BLOCKS;
+  typedef StaticMembers<TypeInfo, I-1> PREV;
+
+  __attribute__((always_inline)) inline static bool check() {
+    return PREV::check() && BLOCKS::check();
+  }
+  __attribute__((always_inline)) inline static void generate() {
+    PREV::generate();
+    BLOCKS::generate();
+  }
+  __attribute__((always_inline)) inline static void update(const void* member) {
+    PREV::update(member);
+    BLOCKS::update(member); // folds to the written segment (see MemberContains)
+  }
+  __attribute__((always_inline)) inline static void commit() {
+    PREV::commit();
+    BLOCKS::commit();
+  }
+  __attribute__((always_inline)) inline static void dirty() {
+    PREV::dirty();
+    BLOCKS::dirty();
+  }
+  // all segments are marked dirty and reset together (see StaticSegments below)
+  __attribute__((always_inline)) inline static const void* get_dirty() {
+    const void* const dirty = PREV::get_dirty();
+    return (dirty != 0) ? dirty : BLOCKS::get_dirty();
+  }
+  __attribute__((always_inline)) inline static bool check_segment(const void* member, bool* found) {
+    const bool result = PREV::check_segment(member, found);
+    if(*found) {
+      return result;
+    }
+    return BLOCKS::check_segment(member, found);
+  }
+};
+
+#else // __acweaving
+
+// dummy to speed up the weaving phase (see JPTL.h)
+template<typename TypeInfo, unsigned I=0>
+struct StaticMembers;
+
+#endif // __acweaving
+
+template<typename TypeInfo>
+struct StaticMembers<TypeInfo, 0> {
+  __attribute__((always_inline)) inline static bool check() { return true; }
+  __attribute__((always_inline)) inline static void generate() {}
+  __attribute__((always_inline)) inline static void update(const void* member) {}
+  __attribute__((always_inline)) inline static void commit() {}
+  __attribute__((always_inline)) inline static void dirty() {}
+  __attribute__((always_inline)) inline static const void* get_dirty() { return 0; }
+  __attribute__((always_inline)) inline static bool check_segment(const void* member, bool* found) { return true; }
+};
+
+
+// the static checksum of a class, with the interface of the Checksumming_* variants
+template<typename TypeInfo>
+class StaticSegments {
+  public:
+  enum { SIZE =
+// puma cannot evaluate this (see Checksumming_SUM+DMR.h)
+#ifndef __puma
+  MemberTraversal<TypeInfo, SizeOfNonPublic, SizeOfNonPublicInit<true> >::EXEC::SIZE
+#else
+  0
+#endif
+  };
+  typedef typename TypeInfo::That T;
+
+  __attribute__((always_inline)) inline static bool __check(T* obj) { return StaticMembers<TypeInfo>::check(); }
+  __attribute__((always_inline)) inline static void __generate(T* obj) { StaticMembers<TypeInfo>::generate(); }
+  __attribute__((always_inline)) inline static void __update(T* obj, const void* member) { StaticMembers<TypeInfo>::update(member); }
+  __attribute__((always_inline)) inline static void __commit(T* obj) { StaticMembers<TypeInfo>::commit(); }
+
+  // verifies the segment containing 'member' only (unless dirty), and nothing for other addresses
+  __attribute__((always_inline)) inline static bool __check_segment(T* obj, const void* member) {
+    bool found = false;
+    return StaticMembers<TypeInfo>::check_segment(member, &found);
+  }
+
+  // used in LockAdviceInvoker
+  __attribute__((always_inline)) inline void __dirty() const { StaticMembers<TypeInfo>::dirty(); }
+  __attribute__((always_inline)) inline const void* const get_dirty() const { return StaticMembers<TypeInfo>::get_dirty(); }
+};
+
+
+// the type of a class's static checksum
+template<typename TypeInfo, bool SEGMENTED=(GOP_USE_STATIC_SEGMENTS != 0)>
+struct StaticChecksumType {
+  typedef Checksumming<TypeInfo, true> Type;
+};
+template<typename TypeInfo>
+struct StaticChecksumType<TypeInfo, true> {
+  typedef StaticSegments<TypeInfo> Type;
+};
+
+} //CoolChecksum
+
+#endif /* __STATIC_SEGMENTS_H__ */
@@ -22,26 +22,42 @@
 // Architecture dependent code to enable/disable preemption
 // For example, on x86/AMD64, interrupts could be disabled
 
+#include "GOP_GlobalConfig.h"
+
 #ifdef __unix__
 #include <pthread.h>
 
 namespace CoolChecksum {
 
-// This class implements the C++ constructor/destructor pattern
+// one mutex per cache line, to avoid false sharing between the stripes
+struct RepairLock {
+  pthread_mutex_t mutex;
+} __attribute__((aligned(GOP_CACHE_LINE_SIZE)));
+
+// This class implements the C++ constructor/destructor pattern.
+// Repairs are serialized per stripe (address hashed), so that
+// repairs of unrelated objects can proceed in parallel.
 class StopPreemption {
 private:
-  pthread_mutex_t* get_mutex() const {
-    static pthread_mutex_t mutex;
-    return &mutex;
+  pthread_mutex_t* mutex;
+
+  static pthread_mutex_t* get_mutex(const void* addr) {
+    // zero-initialized, which equals PTHREAD_MUTEX_INITIALIZER on all supported platforms
+    static RepairLock table[GOP_REPAIR_LOCK_STRIPES];
+    unsigned long key = (unsigned long) addr / GOP_CACHE_LINE_SIZE; // same cache line => same stripe
+    key ^= key >> 7;
+    key ^= key >> 13;
+    return &table[key % GOP_REPAIR_LOCK_STRIPES].mutex;
   }
 
 public:
-  StopPreemption() {
-    pthread_mutex_lock(get_mutex());
+  // addr: the checksum (sub-)object to be repaired
+  StopPreemption(const void* addr) : mutex(get_mutex(addr)) {
+    pthread_mutex_lock(mutex);
   }
 
   ~StopPreemption() {
-    pthread_mutex_unlock(get_mutex());
+    pthread_mutex_unlock(mutex);
   }
 };
 
@@ -52,7 +68,10 @@ public:
 
 namespace CoolChecksum {
 #warning "StopPreemption not implemented!"
-class StopPreemption {};
+class StopPreemption {
+public:
+  StopPreemption(const void* addr) {}
+};
 }
 
 #endif /* __unix__ */
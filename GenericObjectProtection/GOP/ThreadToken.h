@@ -0,0 +1,54 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __THREAD_TOKEN_H__
+#define __THREAD_TOKEN_H__
+
+namespace CoolChecksum {
+
+// A compact, non-zero id of the calling thread: the address of a thread-local variable.
+// In contrast to __builtin_frame_address(0), the id does not depend on the
+// calling function, so that functions setting and resetting the 'dirty' flag
+// need not be inlined into the same frame.
+__attribute__((always_inline)) inline const void* thread_token() {
+  static __thread char token;
+  return &token;
+}
+
+// A unique, non-zero number of the calling thread (1, 2, 3, ...), for ids narrower than a pointer
+// (see GOP_USE_SEQLOCK_FLAGS in ChecksummingBase.h): a truncated thread_token() might collide.
+// A number is taken on the first call, and taken again only after 2^BITS - 1 further threads have
+// taken theirs: a collision needs a thread to outlive 2^31 thread creations (for BITS = 31).
+template<unsigned BITS>
+__attribute__((always_inline)) inline unsigned long thread_number() {
+  static __thread unsigned long number; // zero-initialized: not yet assigned
+  if(__builtin_expect(number == 0, 0)) {
+    static unsigned long counter;
+    const unsigned long mask = (1UL << BITS) - 1;
+    unsigned long next;
+    do {
+      next = __atomic_add_fetch(&counter, 1, __ATOMIC_RELAXED) & mask;
+    } while(next == 0); // 0 is 'no thread'
+    number = next;
+  }
+  return number;
+}
+
+} // namespace CoolChecksum
+
+#endif /* __THREAD_TOKEN_H__ */
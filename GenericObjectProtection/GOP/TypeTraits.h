@@ -119,6 +119,11 @@ struct is_const<const T> {
     enum { IS_CONST = 1 };
 };
 
+template <typename T>
+struct RemoveConst { typedef T Type; };
+template <typename T>
+struct RemoveConst<const T> { typedef T Type; };
+
 //-----------------------------------------------------------------------------
 //--------------------- TEST FOR BASE AND DERIVED CLASSES ---------------------
 //-----------------------------------------------------------------------------
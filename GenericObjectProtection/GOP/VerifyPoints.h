@@ -0,0 +1,84 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#ifndef __VERIFY_POINTS_H__
+#define __VERIFY_POINTS_H__
+
+// Boundary verification (GOP_VERIFY_AT_BOUNDARIES): before each call to one of the
+// verifyPoints(), all protected objects passed by value, by reference, or by pointer
+// are verified (see ChecksumAdviceInvoker.ah). Other arguments are ignored at compile time.
+
+#include "TypeTraits.h"
+
+namespace CoolChecksum {
+
+// protected classes have their own __verify() (see ChecksumSlice.ah)
+template<typename T>
+struct HasVerify {
+  template<typename U, bool (U::*)() const> struct Signature {};
+  template<typename U> static char test(Signature<U, &U::__verify>*);
+  template<typename U> static int test(...);
+  enum { RET = (sizeof(test<T>(0)) == sizeof(char)) };
+};
+
+template<typename T, bool PROTECTED=HasVerify<T>::RET>
+struct VerifyObject {
+  __attribute__((always_inline)) inline static void exec(const T* obj) {
+    if(obj != 0) {
+      obj->__verify(); // uncorrectable errors are reported by the on_error() advice
+    }
+  }
+};
+template<typename T>
+struct VerifyObject<T, false> {
+  __attribute__((always_inline)) inline static void exec(const T* obj) {}
+};
+
+// an argument: the object itself, or the object it points to
+template<typename T>
+struct VerifyArgument {
+  __attribute__((always_inline)) inline static void exec(const T& arg) {
+    VerifyObject<typename RemoveConst<T>::Type>::exec(&arg);
+  }
+};
+template<typename T>
+struct VerifyArgument<T*> {
+  __attribute__((always_inline)) inline static void exec(T* const& arg) {
+    VerifyObject<typename RemoveConst<T>::Type>::exec(arg);
+  }
+};
+template<typename T>
+struct VerifyArgument<T* const> : public VerifyArgument<T*> {};
+
+template<typename JoinPoint, unsigned int I=0, bool LAST=(I == JoinPoint::ARGS)>
+struct VerifyArguments {
+  typedef typename JoinPoint::template Arg<I>::ReferredType Type;
+  __attribute__((always_inline)) inline static void exec(JoinPoint* tjp) {
+    VerifyArgument<Type>::exec(*static_cast<Type*>(tjp->arg(I)));
+    VerifyArguments<JoinPoint, I + 1>::exec(tjp);
+  }
+};
+template<typename JoinPoint, unsigned int I>
+struct VerifyArguments<JoinPoint, I, true> {
+  __attribute__((always_inline)) inline static void exec(JoinPoint* tjp) {}
+};
+
+} //CoolChecksum
+
+#endif /* __VERIFY_POINTS_H__ */
@@ -0,0 +1,209 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __WHOLE_OBJECT_H__
+#define __WHOLE_OBJECT_H__
+
+#include "GOP_GlobalConfig.h"
+#include "ObjectSize.h"
+#include "JPTL.h"
+
+
+namespace CoolChecksum {
+
+// never defined: a surviving call indicates that the compile-time layout (BlockInfo)
+// does not match the compiler's layout (see WholeObject::first)
+void __whole_object_layout_mismatch()
+  __attribute__((error("whole-object checksum: layout mismatch, disable GOP_USE_WHOLE_OBJECT_CHECKSUM")));
+
+// the same, if the bounds are not folded to constants (e.g., -O0): fail-stop on the first access,
+// as the checksum would cover the wrong bytes otherwise
+__attribute__((noinline, noreturn)) inline void __whole_object_layout_error() {
+  __builtin_trap();
+}
+
+
+template<typename MemberInfo, bool STATIC, bool CHECKSUMMED=(bool)MemberDetails<MemberInfo, STATIC>::IS_CHECKSUMMED>
+struct AlignmentOfChecksummed {
+  enum { ALIGNMENT = __alignof__(typename MemberInfo::Type) };
+};
+template<typename MemberInfo, bool STATIC>
+struct AlignmentOfChecksummed<MemberInfo, STATIC, false> {
+  // do not try to evaluate alignof non-checksummed types, cause they might be incomplete
+  enum { ALIGNMENT = 1 };
+};
+
+// compile-time layout of the range [first checksummed member, last checksummed member]
+template<typename MemberInfo, typename LAST>
+struct BlockInfo {
+  struct EXEC {
+    enum { STATIC = LAST::STATIC,
+           MEMBER_IS_CHECKSUMMED = MemberDetails<MemberInfo, STATIC>::IS_CHECKSUMMED,
+           // a non-static member that is not checksummed (e.g., a class-type member)
+           IS_HOLE = (MEMBER_IS_CHECKSUMMED == false) && (MemberDetails<MemberInfo, STATIC>::IS_STATIC == false),
+           FOUND = (LAST::FOUND == true) || (MEMBER_IS_CHECKSUMMED == true),
+           HOLE = (LAST::HOLE == true) || ((LAST::FOUND == true) && (IS_HOLE == true)),
+           // a checksummed member behind a hole splits the range
+           CONTIGUOUS = (LAST::CONTIGUOUS == true) && !((LAST::HOLE == true) && (MEMBER_IS_CHECKSUMMED == true)),
+           ALIGNMENT = AlignmentOfChecksummed<MemberInfo, STATIC>::ALIGNMENT,
+           FIRST_ALIGNMENT = (LAST::FOUND == true) ? LAST::FIRST_ALIGNMENT : ALIGNMENT,
+           MAX_ALIGNMENT = (ALIGNMENT > LAST::MAX_ALIGNMENT) ? ALIGNMENT : LAST::MAX_ALIGNMENT,
+           // a non-static member in front of the first checksummed member
+           LEADING = (LAST::LEADING == true) || ((LAST::FOUND == false) && (IS_HOLE == true)),
+           // offset of the current member, relative to the first checksummed member
+           OFFSET = ((LAST::SIZE + ALIGNMENT - 1) / ALIGNMENT) * ALIGNMENT,
+           SIZE = (MEMBER_IS_CHECKSUMMED == true) ? (OFFSET + SizeOfChecksummed<MemberInfo, STATIC>::SIZE) : LAST::SIZE };
+  };
+};
+template<bool tSTATIC>
+struct BlockInit {
+  // initial EXEC
+  enum { STATIC = tSTATIC, FOUND = 0, HOLE = 0, CONTIGUOUS = 1, SIZE = 0,
+         FIRST_ALIGNMENT = 1, MAX_ALIGNMENT = 1, LEADING = 0 };
+};
+
+// determine the actual bounds of the range (folded to constants by the compiler)
+template<typename MemberInfo, typename LAST>
+struct BlockBounds {
+  typedef typename BlockInfo<MemberInfo, LAST>::EXEC EXEC;
+
+  template<typename T>
+  __attribute__((always_inline)) inline static void exec(T obj, char** first, char** last) {
+    if(EXEC::MEMBER_IS_CHECKSUMMED == true) {
+      char* member = (char*) MemberInfo::pointer(obj);
+      if(*first == 0) {
+        *first = member;
+      }
+      *last = member + SizeOfChecksummed<MemberInfo, EXEC::STATIC>::SIZE;
+    }
+  }
+};
+
+// zero the padding bytes between two checksummed members
+template<typename MemberInfo, typename LAST>
+struct ZeroPadding {
+  typedef typename BlockInfo<MemberInfo, LAST>::EXEC EXEC;
+
+  template<typename T>
+  __attribute__((always_inline)) inline static void exec(T obj, char** cursor) {
+    if(EXEC::MEMBER_IS_CHECKSUMMED == true) {
+      char* member = (char*) MemberInfo::pointer(obj);
+      if(*cursor != 0) {
+        __builtin_memset(*cursor, 0, member - *cursor);
+      }
+      *cursor = member + SizeOfChecksummed<MemberInfo, EXEC::STATIC>::SIZE;
+    }
+  }
+};
+
+
+template<typename TypeInfo, bool STATIC>
+struct WholeObject {
+  typedef typename TypeInfo::That T;
+  typedef typename JPTL::MemberIterator<TypeInfo, BlockInfo, BlockInit<STATIC> >::EXEC LAYOUT;
+
+  // The relative layout (BlockInfo) is exact, if the first checksummed member's offset is a
+  // multiple of all alignments: it is a multiple of its own alignment, and it is 0 (or the size
+  // of the vptr) for the first member of a class without base classes. Otherwise, the padding
+  // is unknown, and the members are traversed one by one.
+  enum { ALIGNED = (LAYOUT::MAX_ALIGNMENT <= LAYOUT::FIRST_ALIGNMENT) ||
+                   ((TypeInfo::BASECLASSES == 0) && (LAYOUT::LEADING == false) &&
+                    (LAYOUT::MAX_ALIGNMENT <= __alignof__(void*))) };
+
+  // the static members are not contiguous, thus, only non-static checksums are affected
+  enum { ENABLED = (GOP_USE_WHOLE_OBJECT_CHECKSUM != 0) && (STATIC == false) &&
+                   (LAYOUT::CONTIGUOUS == true) && (LAYOUT::SIZE != 0) && (ALIGNED == true),
+         SIZE = LAYOUT::SIZE };
+
+  __attribute__((always_inline)) inline static char* first(const T* obj) {
+    char* first = 0;
+    char* last = 0;
+    JPTL::MemberIterator<TypeInfo, BlockBounds, BlockInit<STATIC> >::exec(const_cast<T*>(obj), &first, &last);
+    // The member offsets are not available as constants (only through MemberInfo::pointer()),
+    // thus, the check is a compile-time error where the optimizer folds the bounds, and a
+    // (constant, well-predicted) comparison at run time where it does not
+    if(__builtin_constant_p(last - first)) {
+      if((last - first) != SIZE) {
+        __whole_object_layout_mismatch(); // compile-time error, if this call is not optimized out
+      }
+    }
+    else if((last - first) != SIZE) {
+      __whole_object_layout_error();
+    }
+    return first;
+  }
+
+  // used after construction: the padding is part of the checksum and must be deterministic
+  __attribute__((always_inline)) inline static void zero_padding(T* obj) {
+    if(ENABLED) {
+      char* cursor = 0;
+      JPTL::MemberIterator<TypeInfo, ZeroPadding, BlockInit<STATIC> >::exec(obj, &cursor);
+    }
+  }
+};
+
+// pseudo member info, describing the whole range as a single unsigned char array
+template<typename TypeInfo, bool STATIC>
+struct WholeObjectMember {
+  typedef unsigned char Type[WholeObject<TypeInfo, STATIC>::SIZE];
+  typedef Type ReferredType;
+  static const AC::Protection prot = AC::PROT_PRIVATE;
+  static const AC::Specifiers spec = AC::SPEC_NONE;
+  __attribute__((always_inline)) inline static ReferredType* pointer(const typename TypeInfo::That* obj) {
+    return (ReferredType*) WholeObject<TypeInfo, STATIC>::first(obj);
+  }
+  static const char* name() { return "__whole_object"; }
+};
+
+
+// Used instead of JPTL::MemberIterator by all Checksumming_* variants:
+// either iterates over all members, or visits the whole range once as a single member.
+// Thus, one CRC/SUM/XOR loop covers the object, and repairs become block copies.
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename INIT,
+         bool BLOCK=WholeObject<TypeInfo, INIT::STATIC>::ENABLED>
+struct MemberTraversal : public JPTL::MemberIterator<TypeInfo, Action, INIT> {};
+
+template<typename TypeInfo,
+         template <typename, typename> class Action,
+         typename INIT>
+struct MemberTraversal<TypeInfo, Action, INIT, true> {
+  typedef WholeObjectMember<TypeInfo, INIT::STATIC> MEMBER_TYPE_INFO;
+  typedef typename JPTL::SFINAE_CHECK::EXEC::GET< Action<MEMBER_TYPE_INFO, INIT> >::Type EXEC;
+
+  __attribute__((always_inline)) inline static void exec() {
+    Action<MEMBER_TYPE_INFO, INIT>::exec();
+  }
+  template<typename ARG_0>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0) {
+    Action<MEMBER_TYPE_INFO, INIT>::exec(arg0);
+  }
+  template<typename ARG_0, typename ARG_1>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1) {
+    Action<MEMBER_TYPE_INFO, INIT>::exec(arg0, arg1);
+  }
+  template<typename ARG_0, typename ARG_1, typename ARG_2>
+  __attribute__((always_inline)) inline static void exec(ARG_0 arg0, ARG_1 arg1, ARG_2 arg2) {
+    Action<MEMBER_TYPE_INFO, INIT>::exec(arg0, arg1, arg2);
+  }
+};
+
+} //CoolChecksum
+
+#endif /* __WHOLE_OBJECT_H__ */
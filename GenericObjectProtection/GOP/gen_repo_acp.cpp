@@ -0,0 +1,133 @@
+/*
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Synthetic project model (repo.acp) for timing the static analysis (q5.xqy, see q5_bench.sh):
+// 'classes' classes with FUNCTIONS member functions and MEMBERS data members each. Every function
+// calls member functions of, and reads/writes data members of, a few objects in a few blocks,
+// such that runs of calls/accesses to the same object occur. A few functions are left undefined
+// or call through a pointer (CallRef), which makes their callers long-running (shortFunctions()).
+// Only the elements and attributes q5.xqy reads are generated. The output is deterministic.
+//
+// usage: gen_repo_acp [classes (100)] [statements per function (24)] > repo.acp
+
+#include <stdio.h>
+#include <stdlib.h>
+
+enum { FUNCTIONS = 8, MEMBERS = 4, OBJECTS = 3, BLOCKS = 3 };
+
+static unsigned int seed = 1;
+
+static unsigned int next_random(unsigned int range) {
+  seed = seed * 1103515245u + 12345u;
+  return (seed >> 16) % range;
+}
+
+// ids: 0 file, 1 namespace, then per class: class, members, functions
+static unsigned int class_id(unsigned int c) {
+  return 2 + c * (1 + MEMBERS + FUNCTIONS);
+}
+static unsigned int member_id(unsigned int c, unsigned int m) {
+  return class_id(c) + 1 + m;
+}
+static unsigned int function_id(unsigned int c, unsigned int f) {
+  return class_id(c) + 1 + MEMBERS + f;
+}
+
+int main(int argc, char** argv) {
+  const unsigned int classes = (argc > 1) ? atoi(argv[1]) : 100;
+  const unsigned int statements = (argc > 2) ? atoi(argv[2]) : 24;
+
+  if(classes == 0) {
+    fprintf(stderr, "gen_repo_acp: at least one class\n");
+    return 1;
+  }
+
+  printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+  printf("<ac-model version=\"1.2\" ids=\"%u\">\n", class_id(classes));
+  printf("  <files>\n    <TUnit filename=\"synthetic.cpp\" len=\"%u\" time=\"0\" id=\"0\"/>\n  </files>\n",
+         classes * FUNCTIONS * (statements + 2));
+  printf("  <root>\n    <Namespace name=\"::\" id=\"1\">\n      <children>\n");
+
+  unsigned int line = 1;
+  for(unsigned int c = 0; c < classes; c++) {
+    printf("        <Class name=\"C%u\" id=\"%u\">\n          <children>\n", c, class_id(c));
+
+    for(unsigned int m = 0; m < MEMBERS; m++) {
+      printf("            <Variable name=\"m%u\" id=\"%u\" kind=\"3\">"
+             "<type><Type signature=\"int\"/></type></Variable>\n", m, member_id(c, m));
+    }
+
+    for(unsigned int f = 0; f < FUNCTIONS; f++) {
+      // every 16th function is declared only (e.g., a library function)
+      const bool defined = ((c * FUNCTIONS + f) % 16) != 15;
+
+      printf("            <Function name=\"f%u\" id=\"%u\" kind=\"3\" cv_qualifiers=\"0\">\n", f, function_id(c, f));
+      printf("              <result_type><Type signature=\"void\"/></result_type>\n");
+      printf("              <arg_types><Type signature=\"int\"/></arg_types>\n");
+      printf("              <source><Source kind=\"%u\" file=\"0\" line=\"%u\" len=\"%u\"/></source>\n",
+             defined ? 1 : 0, line, statements + 2);
+      line++;
+
+      if(defined == false) {
+        printf("            </Function>\n");
+        line += statements + 1;
+        continue;
+      }
+
+      printf("              <children>\n");
+      for(unsigned int lid = 0; lid < statements; lid++, line++) {
+        // statements come in blocks; the objects are local to the function
+        const unsigned int block = (lid * BLOCKS) / statements;
+        const unsigned int object = next_random(OBJECTS);
+        const unsigned int target_class = (c + 1 + next_random(4)) % classes;
+        const unsigned int kind = next_random(8);
+
+        if(kind < 3) {
+          printf("                <Call target=\"%u\" lid=\"%u\" target_class=\"%u\" cfg_block_lid=\"%u\" "
+                 "target_object_lid=\"%u\"><source><Source file=\"0\" line=\"%u\"/></source></Call>\n",
+                 function_id(target_class, next_random(FUNCTIONS)), lid, class_id(target_class),
+                 block, object, line);
+        }
+        else if(kind < 5) {
+          printf("                <Get target=\"%u\" lid=\"%u\" target_class=\"%u\" cfg_block_lid=\"%u\" "
+                 "target_object_lid=\"%u\"><source><Source file=\"0\" line=\"%u\"/></source></Get>\n",
+                 member_id(target_class, next_random(MEMBERS)), lid, class_id(target_class),
+                 block, object, line);
+        }
+        else if(kind < 7 || (c * FUNCTIONS + f) % 32 != 7) {
+          printf("                <Set target=\"%u\" lid=\"%u\" target_class=\"%u\" cfg_block_lid=\"%u\" "
+                 "target_object_lid=\"%u\"><source><Source file=\"0\" line=\"%u\"/></source></Set>\n",
+                 member_id(target_class, next_random(MEMBERS)), lid, class_id(target_class),
+                 block, object, line);
+        }
+        else {
+          // a call through a function pointer (every 32nd function only)
+          printf("                <CallRef lid=\"%u\"/>\n", lid);
+        }
+      }
+      printf("              </children>\n            </Function>\n");
+      line++;
+    }
+
+    printf("          </children>\n        </Class>\n");
+  }
+
+  printf("      </children>\n    </Namespace>\n  </root>\n</ac-model>\n");
+  return 0;
+}
@@ -0,0 +1,160 @@
+/* 
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Post-processing of the instrumentation build's trace (GOP_PROFILE, see Profiler.h):
+// counts how often an object is left at call site A and entered again right away at
+// call site B (by the same thread), i.e., the pairs whose leave (generate) and enter
+// (check) q5.xqy may skip. The pairs that cover the given share of the overhead
+// (count * size of the object) are written to profile.xml, hottest pair first.
+//
+// usage: gop_profile [trace (gop_profile.bin)] [percent (90)] > profile.xml
+
+#include "Profiler.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <vector>
+#include <string>
+#include <algorithm>
+
+using namespace CoolChecksum;
+
+struct Site {
+  std::string file;
+  std::string signature;
+  unsigned int line;
+  unsigned int weight;
+};
+
+struct Pair {
+  unsigned int leave;
+  unsigned int enter;
+  unsigned long long count;
+  unsigned long long overhead;
+};
+
+static bool hotter(const Pair& a, const Pair& b) {
+  return a.overhead > b.overhead;
+}
+
+static bool read_string(FILE* in, std::string& s) {
+  int c;
+  s.clear();
+  while((c = fgetc(in)) > 0) {
+    s += (char) c;
+  }
+  return c == 0;
+}
+
+static std::string escape(const std::string& s) {
+  std::string result;
+  for(std::string::size_type i = 0; i < s.size(); i++) {
+    switch(s[i]) {
+      case '&': result += "&amp;"; break;
+      case '<': result += "&lt;"; break;
+      case '>': result += "&gt;"; break;
+      case '"': result += "&quot;"; break;
+      default: result += s[i];
+    }
+  }
+  return result;
+}
+
+int main(int argc, char** argv) {
+  const char* name = (argc > 1) ? argv[1] : "gop_profile.bin";
+  const double percent = (argc > 2) ? atof(argv[2]) : 90.0;
+
+  FILE* in = fopen(name, "rb");
+  if(in == 0) {
+    perror(name);
+    return 1;
+  }
+
+  std::map<unsigned int, Site> sites; // jpid -> site
+  std::map<unsigned int, ProfileRecord> last; // thread -> previous record
+  std::map<std::pair<unsigned int, unsigned int>, unsigned long long> pairs; // (leave, enter) -> count
+
+  // a site may be described after its first records (by another thread): resolve at the end
+  ProfileHeader header;
+  while(fread(&header, sizeof(header), 1, in) == 1) {
+    if(header.magic == ProfileHeader::SITE) {
+      Site& site = sites[header.id];
+      site.line = header.count;
+      site.weight = header.weight;
+      if((read_string(in, site.file) == false) || (read_string(in, site.signature) == false)) {
+        break;
+      }
+    }
+    else if(header.magic == ProfileHeader::CHUNK) {
+      if(header.count == 0) {
+        continue;
+      }
+      std::vector<ProfileRecord> records(header.count);
+      if(fread(&records[0], sizeof(ProfileRecord), header.count, in) != header.count) {
+        break;
+      }
+      // the chunks of a thread continue each other
+      const bool first = (last.find(header.id) == last.end());
+      ProfileRecord prev = last[header.id];
+      for(unsigned int i = 0; i < header.count; i++) {
+        const ProfileRecord& r = records[i];
+        if(((first == false) || (i != 0)) &&
+           ((prev.event & 1) == ProfileRecord::LEAVE) && ((r.event & 1) == ProfileRecord::ENTER) &&
+           (prev.object == r.object)) {
+          pairs[std::make_pair(prev.event >> 1, r.event >> 1)]++;
+        }
+        prev = r;
+      }
+      last[header.id] = prev;
+    }
+    else {
+      fprintf(stderr, "%s: corrupt trace\n", name);
+      break;
+    }
+  }
+  fclose(in);
+
+  std::vector<Pair> ranking;
+  unsigned long long total = 0;
+  for(std::map<std::pair<unsigned int, unsigned int>, unsigned long long>::const_iterator it = pairs.begin();
+      it != pairs.end(); ++it) {
+    Pair p = { it->first.first, it->first.second, it->second, it->second * sites[it->first.second].weight };
+    ranking.push_back(p);
+    total += p.overhead;
+  }
+  std::sort(ranking.begin(), ranking.end(), hotter);
+
+  printf("<?xml version=\"1.0\"?>\n<Profile total=\"%llu\" percent=\"%g\">\n", total, percent);
+  unsigned long long covered = 0;
+  for(std::vector<Pair>::const_iterator it = ranking.begin();
+      (it != ranking.end()) && (covered < total * (percent / 100.0)); ++it) {
+    const Site& leave = sites[it->leave];
+    const Site& enter = sites[it->enter];
+    printf("  <Pair leave_file=\"%s\" leave_line=\"%u\" leave_signature=\"%s\""
+           " enter_file=\"%s\" enter_line=\"%u\" enter_signature=\"%s\""
+           " count=\"%llu\" overhead=\"%llu\"/>\n",
+           escape(leave.file).c_str(), leave.line, escape(leave.signature).c_str(),
+           escape(enter.file).c_str(), enter.line, escape(enter.signature).c_str(),
+           it->count, it->overhead);
+    covered += it->overhead;
+  }
+  printf("</Profile>\n");
+  return 0;
+}
@@ -0,0 +1,78 @@
+#!/bin/sh
+#
+# This file is part of the library of dependability aspects.
+# See: http://dx.doi.org/10.17877/DE290R-17995
+# Copyright (c) 2017 Christoph Borchert.
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, version 3.
+#
+# This program is distributed in the hope that it will be useful, but
+# WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+# General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program. If not, see <http://www.gnu.org/licenses/>.
+#
+
+# Times q5.xqy on synthetic models (gen_repo_acp.cpp) of growing size, or on given models
+# (e.g., the repo.acp of a woven project), without profile.xml.
+# The XQuery 3.1 processor is given by $XQUERY, followed directly by the query file, e.g.:
+#   XQUERY="java -cp saxon-he.jar net.sf.saxon.Query -q:" ./q5_bench.sh
+#   XQUERY="basex " ./q5_bench.sh 10 100 1000
+# With $REFERENCE (another version of the query, e.g. "git show <commit>:./q5.xqy > old.xqy"),
+# that one is timed, too, and both generated aspects must be identical:
+#   REFERENCE=old.xqy ./q5_bench.sh 100 ../repo.acp
+#
+# usage: q5_bench.sh [number of classes | repo.acp ...] (default: 10 30 100 300)
+
+set -e
+
+DIR=$(cd "$(dirname "$0")" && pwd)
+XQUERY=${XQUERY:-"java -cp ${SAXON_JAR:-saxon-he.jar} net.sf.saxon.Query -q:"}
+SIZES=${*:-"10 30 100 300"}
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+g++ -O2 "$DIR/gen_repo_acp.cpp" -o "$WORK/gen_repo_acp"
+# doc("repo.acp") is resolved relative to the query
+cp "$DIR/q5.xqy" "$WORK/q5.xqy"
+if [ -n "$REFERENCE" ]; then
+  cp "$REFERENCE" "$WORK/reference.xqy"
+fi
+
+# run <query> <output>: prints the seconds
+run() {
+  start=$(date +%s.%N)
+  $XQUERY"$WORK/$1" > "$WORK/$2"
+  end=$(date +%s.%N)
+  awk "BEGIN { printf \"%.2f\", $end - $start }"
+}
+
+status=0
+printf "%8s %10s %10s %10s %10s\n" classes functions bytes seconds reference
+for n in $SIZES; do
+  if [ -f "$n" ]; then
+    cp "$n" "$WORK/repo.acp"
+  else
+    "$WORK/gen_repo_acp" "$n" > "$WORK/repo.acp"
+  fi
+  seconds=$(run q5.xqy GOP_Static_Optimization.ah)
+  reference=-
+  if [ -n "$REFERENCE" ]; then
+    reference=$(run reference.xqy reference.ah)
+  fi
+  printf "%8s %10s %10s %10.2f %10s\n" "$(basename "$n")" $(grep -c "<Function " "$WORK/repo.acp") \
+         $(wc -c < "$WORK/repo.acp") "$seconds" "$reference"
+  # the counters at the end of the generated aspect
+  tail -n 2 "$WORK/GOP_Static_Optimization.ah" | head -n 1
+  if [ -n "$REFERENCE" ] && ! cmp -s "$WORK/GOP_Static_Optimization.ah" "$WORK/reference.ah"; then
+    echo "q5_bench.sh: the generated aspects differ from the reference:"
+    diff "$WORK/reference.ah" "$WORK/GOP_Static_Optimization.ah" | head -n 20 || true
+    status=1
+  fi
+done
+exit $status
@@ -0,0 +1,205 @@
+/*
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Lock contention of the enter/leave protocol (see LockAdviceInvoker.ah): N threads enter and
+// leave one shared object ("shared"), or an object of their own ("private", one cache line each).
+//  old: __is_unlocked() (plain load), then __lock() (__sync_fetch_and_add) on enter,
+//       mfence(), __is_locked() and __unlock() (__sync_fetch_and_sub) on leave
+//  new: __enter_lock() (a single acquire CAS, uncontended) and __verified() on enter,
+//       __is_locked() (acquire load) and __unlock() (release fetch_sub) on leave
+// The first to enter verifies, the last to leave generates a (plain sum) checksum.
+//
+// usage: enter_lock [max. threads (number of CPUs)] [seconds per run (1)]
+
+#include "Locker.h"
+#include "MemoryBarriers.h"
+#include "GOP_GlobalConfig.h"
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+using namespace CoolChecksum;
+
+// the protocol before the single fetch-and-add
+class OldLocker : public ChksumLocker<true> {
+  public:
+  __attribute__((always_inline)) inline bool __is_unlocked() const {
+    if(this->lock == B_CONSTANT) {
+      return true;
+    }
+    __check();
+    return false;
+  }
+  __attribute__((always_inline)) inline void __lock() const {
+    __sync_fetch_and_add(&(this->lock), A_CONSTANT);
+  }
+  __attribute__((always_inline)) inline bool __is_locked() const {
+    return (*(volatile unsigned int*) &(this->lock) != (A_CONSTANT+B_CONSTANT));
+  }
+  __attribute__((always_inline)) inline void __unlock() const {
+    __sync_fetch_and_sub(&(this->lock), A_CONSTANT);
+  }
+};
+
+enum { MEMBERS = 4 };
+
+struct Object {
+  unsigned int member[MEMBERS];
+  unsigned int __chksum;
+  OldLocker __locker; // the new protocol is the one of the base class
+
+  Object() : __chksum(0) {
+    for(unsigned int i = 0; i < MEMBERS; i++) {
+      member[i] = 0;
+    }
+  }
+
+  unsigned int sum() const {
+    unsigned int s = 0;
+    for(unsigned int i = 0; i < MEMBERS; i++) {
+      s += member[i];
+    }
+    return s;
+  }
+  void verify() const {
+    if(sum() != __atomic_load_n(&__chksum, __ATOMIC_RELAXED)) {
+      abort(); // no bit flips injected
+    }
+  }
+  void generate() {
+    __atomic_store_n(&__chksum, sum(), __ATOMIC_RELAXED);
+  }
+
+  __attribute__((noinline)) void enter_leave_old() {
+    if(__locker.__is_unlocked()) {
+      verify();
+    }
+    __locker.__lock();
+    mfence();
+    if(__locker.__is_locked() == false) {
+      generate();
+    }
+    __locker.__unlock();
+  }
+
+  __attribute__((noinline)) void enter_leave_new() {
+    const ChksumLocker<true>& locker = __locker;
+    if(locker.__enter_lock()) {
+      verify();
+      locker.__verified();
+    }
+    if(locker.__is_locked() == false) {
+      generate();
+    }
+    locker.__unlock();
+  }
+} __attribute__((aligned(GOP_CACHE_LINE_SIZE)));
+
+static volatile bool running;
+
+template<bool NEW>
+struct Worker {
+  Object* object;
+  unsigned long long operations;
+  pthread_t thread;
+
+  static void* run(void* arg) {
+    Worker* self = (Worker*) arg;
+    unsigned long long n = 0;
+    while(__atomic_load_n(&running, __ATOMIC_RELAXED)) {
+      for(unsigned int i = 0; i < 1024; i++) {
+        if(NEW) {
+          self->object->enter_leave_new();
+        }
+        else {
+          self->object->enter_leave_old();
+        }
+      }
+      n += 1024;
+    }
+    self->operations = n;
+    return 0;
+  }
+};
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// million enter/leave pairs per second of all threads together
+template<bool NEW>
+static double measure(unsigned int threads, bool shared, double seconds) {
+  Object* objects; // the alignment is ignored by operator new (before C++17)
+  if(posix_memalign((void**) &objects, GOP_CACHE_LINE_SIZE, threads * sizeof(Object)) != 0) {
+    perror("posix_memalign");
+    exit(1);
+  }
+  for(unsigned int i = 0; i < threads; i++) {
+    new (&objects[i]) Object();
+  }
+  Worker<NEW>* workers = new Worker<NEW>[threads];
+
+  running = true;
+  const double start = now();
+  for(unsigned int i = 0; i < threads; i++) {
+    workers[i].object = shared ? &objects[0] : &objects[i];
+    pthread_create(&workers[i].thread, 0, Worker<NEW>::run, &workers[i]);
+  }
+  usleep((useconds_t) (seconds * 1e6));
+  __atomic_store_n(&running, false, __ATOMIC_RELAXED);
+
+  unsigned long long operations = 0;
+  for(unsigned int i = 0; i < threads; i++) {
+    pthread_join(workers[i].thread, 0);
+    operations += workers[i].operations;
+  }
+  const double elapsed = now() - start;
+
+  delete[] workers;
+  free(objects);
+  return operations / elapsed / 1e6;
+}
+
+int main(int argc, char** argv) {
+  const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  const unsigned int max_threads = (argc > 1) ? atoi(argv[1]) : ((cpus > 0) ? cpus : 1);
+  const double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+
+  printf("%8s %12s %12s %12s %12s   [M enter/leave per second]\n",
+         "threads", "shared old", "shared new", "private old", "private new");
+
+  // 1, 2, 4, ..., max_threads
+  for(unsigned int threads = 1; ; threads = (threads * 2 < max_threads) ? threads * 2 : max_threads) {
+    const double shared_old = measure<false>(threads, true, seconds);
+    const double shared_new = measure<true>(threads, true, seconds);
+    const double private_old = measure<false>(threads, false, seconds);
+    const double private_new = measure<true>(threads, false, seconds);
+    printf("%8u %12.1f %12.1f %12.1f %12.1f\n", threads, shared_old, shared_new, private_old, private_new);
+    if(threads >= max_threads) {
+      break;
+    }
+  }
+  return 0;
+}
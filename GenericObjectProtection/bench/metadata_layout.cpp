@@ -0,0 +1,154 @@
+/*
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// False sharing between adjacent synchronized objects (see MetadataLayout.h): N threads hammer
+// enter/write/leave on N adjacent objects of an array, one object per thread, i.e., there is no
+// true sharing at all. The objects mimic the woven ones: a few members, followed by __chksum
+// and __locker with the alignments of the packed, padded-locker, and colocated layout.
+// The checksum is a plain sum (the variant is not the point here).
+//
+// usage: metadata_layout [max. threads (number of CPUs)] [seconds per run (1)]
+
+#include "Locker.h"
+#include "MetadataLayout.h"
+
+#include <new>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+using namespace CoolChecksum;
+
+enum { MEMBERS = 3 };
+
+template<unsigned LAYOUT>
+struct Object {
+  unsigned int member[MEMBERS];
+  unsigned int __chksum __attribute__((aligned(MetadataLayout<LAYOUT>::CHECKSUM_ALIGNMENT)));
+  ChksumLocker<true> __locker __attribute__((aligned(MetadataLayout<LAYOUT>::LOCKER_ALIGNMENT)));
+
+  __attribute__((noinline)) void update(unsigned int value) {
+    if(__locker.__enter_lock()) {
+      unsigned int sum = 0;
+      for(unsigned int i = 0; i < MEMBERS; i++) {
+        sum += member[i];
+      }
+      if(sum != __chksum) {
+        abort(); // no bit flips injected
+      }
+      __locker.__verified();
+    }
+    member[value % MEMBERS] += value;
+    if(__locker.__leave_unlock()) {
+      unsigned int sum = 0;
+      for(unsigned int i = 0; i < MEMBERS; i++) {
+        sum += member[i];
+      }
+      __chksum = sum;
+    }
+  }
+};
+
+static volatile bool running;
+
+template<unsigned LAYOUT>
+struct Worker {
+  Object<LAYOUT>* object;
+  unsigned long long operations;
+  pthread_t thread;
+
+  static void* run(void* arg) {
+    Worker* self = (Worker*) arg;
+    unsigned long long n = 0;
+    while(__atomic_load_n(&running, __ATOMIC_RELAXED)) {
+      for(unsigned int i = 0; i < 1024; i++) {
+        self->object->update(i);
+      }
+      n += 1024;
+    }
+    self->operations = n;
+    return 0;
+  }
+};
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+// million enter/leave pairs per second of all threads together
+template<unsigned LAYOUT>
+static double measure(unsigned int threads, double seconds) {
+  Object<LAYOUT>* objects;
+  if(posix_memalign((void**) &objects, GOP_CACHE_LINE_SIZE, threads * sizeof(Object<LAYOUT>)) != 0) {
+    perror("posix_memalign");
+    exit(1);
+  }
+  for(unsigned int i = 0; i < threads; i++) {
+    new (&objects[i]) Object<LAYOUT>();
+  }
+
+  Worker<LAYOUT>* workers = new Worker<LAYOUT>[threads];
+  running = true;
+  const double start = now();
+  for(unsigned int i = 0; i < threads; i++) {
+    workers[i].object = &objects[i];
+    pthread_create(&workers[i].thread, 0, Worker<LAYOUT>::run, &workers[i]);
+  }
+  usleep((useconds_t) (seconds * 1e6));
+  __atomic_store_n(&running, false, __ATOMIC_RELAXED);
+
+  unsigned long long operations = 0;
+  for(unsigned int i = 0; i < threads; i++) {
+    pthread_join(workers[i].thread, 0);
+    operations += workers[i].operations;
+  }
+  const double elapsed = now() - start;
+
+  delete[] workers;
+  free(objects);
+  return operations / elapsed / 1e6;
+}
+
+int main(int argc, char** argv) {
+  const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  const unsigned int max_threads = (argc > 1) ? atoi(argv[1]) : ((cpus > 0) ? cpus : 1);
+  const double seconds = (argc > 2) ? atof(argv[2]) : 1.0;
+
+  printf("sizeof: packed %u, padded locker %u, colocated %u bytes\n",
+         (unsigned) sizeof(Object<METADATA_LAYOUT_PACKED>),
+         (unsigned) sizeof(Object<METADATA_LAYOUT_PADDED_LOCKER>),
+         (unsigned) sizeof(Object<METADATA_LAYOUT_COLOCATED>));
+  printf("%8s %14s %14s %14s   [M enter/leave per second]\n", "threads", "packed", "padded locker", "colocated");
+
+  // 1, 2, 4, ..., max_threads
+  for(unsigned int threads = 1; ; threads = (threads * 2 < max_threads) ? threads * 2 : max_threads) {
+    const double packed = measure<METADATA_LAYOUT_PACKED>(threads, seconds);
+    const double padded = measure<METADATA_LAYOUT_PADDED_LOCKER>(threads, seconds);
+    const double colocated = measure<METADATA_LAYOUT_COLOCATED>(threads, seconds);
+    printf("%8u %14.1f %14.1f %14.1f\n", threads, packed, padded, colocated);
+    if(threads >= max_threads) {
+      break;
+    }
+  }
+  return 0;
+}
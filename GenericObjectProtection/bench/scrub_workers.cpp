@@ -0,0 +1,148 @@
+/*
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Scrubbing throughput (see Scrubber.h) over the number of workers: the objects of a registered
+// class are verified by Scrubber::pass() in the calling thread, and by 1, 2, 4, ... workers
+// without a byte budget. The objects mimic the woven ones: a payload, __chksum, __locker,
+// and __registry_node; __scrub() skips objects in use and verifies a plain sum.
+// Reported is the best of a few passes, in objects per second (Scrubber::objects_per_second()).
+//
+// usage: scrub_workers [objects (1000000)] [max. workers (number of CPUs)] [passes (5)]
+
+#include "Scrubber.h"
+#include "Locker.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace CoolChecksum;
+
+enum { PAYLOAD = 14 }; // 56 bytes of members, plus the metadata
+
+struct Object {
+  enum { SYNCHRONIZED = 1 };
+  unsigned int payload[PAYLOAD];
+  unsigned int __chksum;
+  ChksumLocker<true> __locker;
+  RegistryNode __registry_node;
+
+  Object(unsigned int seed) {
+    unsigned int sum = 0;
+    for(unsigned int i = 0; i < PAYLOAD; i++) {
+      payload[i] = seed * 2654435761u + i;
+      sum += payload[i];
+    }
+    __chksum = sum;
+    Registry<Object>::add(this);
+  }
+  ~Object() {
+    Registry<Object>::remove(this);
+  }
+
+  bool __scrub() const {
+    if(__locker.__is_unlocked() == false) {
+      return true; // in use: verified on its next enter
+    }
+    unsigned int sum = 0;
+    for(unsigned int i = 0; i < PAYLOAD; i++) {
+      sum += payload[i];
+    }
+    return (sum == __chksum);
+  }
+};
+
+static void pause_ms(unsigned int ms) {
+  struct timespec ts = { (time_t) (ms / 1000), (long) (ms % 1000) * 1000000L };
+  nanosleep(&ts, 0);
+}
+
+// best of 'passes' passes of the given number of workers (0: Scrubber::pass() in this thread)
+static unsigned long measure(unsigned int workers, unsigned int passes) {
+  unsigned long best = 0;
+  if(workers == 0) {
+    for(unsigned int p = 0; p < passes; p++) {
+      Scrubber::pass();
+      const unsigned long rate = Scrubber::objects_per_second();
+      best = (rate > best) ? rate : best;
+    }
+    return best;
+  }
+
+  if(Scrubber::start(0, -1, workers, 0) == false) {
+    fprintf(stderr, "scrub_workers: cannot start %u workers\n", workers);
+    exit(1);
+  }
+  const unsigned long first = Scrubber::passes();
+  unsigned long seen = first;
+  while(seen < first + passes) {
+    pause_ms(1);
+    const unsigned long current = Scrubber::passes();
+    if(current != seen) {
+      // the statistics of the pass just completed (a pass shorter than the poll interval may be missed)
+      const unsigned long rate = Scrubber::objects_per_second();
+      best = (rate > best) ? rate : best;
+      seen = current;
+    }
+  }
+  Scrubber::stop();
+  return best;
+}
+
+int main(int argc, char** argv) {
+  const unsigned long count = (argc > 1) ? atol(argv[1]) : 1000000;
+  const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  unsigned int max_workers = (argc > 2) ? atoi(argv[2]) : ((cpus > 0) ? cpus : 1);
+  const unsigned int passes = (argc > 3) ? atoi(argv[3]) : 5;
+
+  if(max_workers > GOP_SCRUB_MAX_WORKERS) {
+    max_workers = GOP_SCRUB_MAX_WORKERS;
+  }
+
+  // allocated one by one, as the objects of a long-running application would be
+  Object** objects = new Object*[count];
+  for(unsigned long i = 0; i < count; i++) {
+    objects[i] = new Object(i);
+  }
+
+  printf("%lu objects of %u bytes, %u registry shards\n", count, (unsigned) sizeof(Object), GOP_REGISTRY_SHARDS);
+  printf("%8s %16s %10s\n", "workers", "objects/s", "speedup");
+  const unsigned long single = measure(0, passes);
+  printf("%8s %16lu %10.2f\n", "pass()", single, 1.0);
+
+  // 1, 2, 4, ..., max_workers
+  for(unsigned int workers = 1; ; workers = (workers * 2 < max_workers) ? workers * 2 : max_workers) {
+    const unsigned long rate = measure(workers, passes);
+    printf("%8u %16lu %10.2f\n", workers, rate, (single == 0) ? 0.0 : (double) rate / single);
+    if(workers >= max_workers) {
+      break;
+    }
+  }
+
+  if(Scrubber::uncorrectable() != 0) {
+    fprintf(stderr, "scrub_workers: %lu uncorrectable objects (no bit flips injected)\n", Scrubber::uncorrectable());
+    return 1;
+  }
+  for(unsigned long i = 0; i < count; i++) {
+    delete objects[i];
+  }
+  delete[] objects;
+  return 0;
+}
@@ -0,0 +1,155 @@
+/*
+ * This file is part of the library of dependability aspects.
+ * See: http://dx.doi.org/10.17877/DE290R-17995
+ * Copyright (c) 2017 Christoph Borchert.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+// Bulk vs. per-element verification of an array of protected objects (see Range.h):
+//  per element: the virtual, out-of-line __verify() of each object (as woven for classes with
+//               inheritance, see ChecksumSlice.ah)
+//  inlined:     __verify_exact() of each object, without prefetching
+//  verify_range(): __verify_exact() with the next elements' object and checksum prefetched
+// The objects mimic the woven ones: a payload, a base class, and a checksum (a plain sum,
+// with the dirty early return) behind it. Arrays of growing size, from cache-resident to DRAM.
+//
+// usage: verify_range [max. objects (4194304)] [repetitions (5)]
+
+#include "Range.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+enum { PAYLOAD = 20 };
+
+struct Base {
+  unsigned int base[4];
+  virtual ~Base() {}
+  virtual bool __verify() const = 0;
+};
+
+struct Object : public Base {
+  unsigned int payload[PAYLOAD];
+  const void* dirty;
+  unsigned int __chksum;
+
+  Object() : dirty(0) {
+    for(unsigned int i = 0; i < 4; i++) {
+      base[i] = rand();
+    }
+    for(unsigned int i = 0; i < PAYLOAD; i++) {
+      payload[i] = rand();
+    }
+    __chksum = sum();
+  }
+
+  __attribute__((always_inline)) inline unsigned int sum() const {
+    unsigned int s = 0;
+    for(unsigned int i = 0; i < 4; i++) {
+      s += base[i];
+    }
+    for(unsigned int i = 0; i < PAYLOAD; i++) {
+      s += payload[i];
+    }
+    return s;
+  }
+
+  __attribute__((always_inline)) inline const void* __chksum_address() const { return &__chksum; }
+  __attribute__((always_inline)) inline bool __verify_exact() const {
+    if(dirty != 0) {
+      return true; // being modified
+    }
+    return (sum() == __chksum);
+  }
+  virtual bool __verify() const __attribute__((noinline));
+};
+
+bool Object::__verify() const {
+  return __verify_exact();
+}
+
+static double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+__attribute__((noinline)) static unsigned long per_element(Object* first, Object* last) {
+  unsigned long failed = 0;
+  for(; first != last; ++first) {
+    const Base* base = first; // not devirtualized, as through a pointer in the application
+    __asm__ __volatile__("" : "+r"(base));
+    if(base->__verify() == false) {
+      failed++;
+    }
+  }
+  return failed;
+}
+
+__attribute__((noinline)) static unsigned long inlined(Object* first, Object* last) {
+  unsigned long failed = 0;
+  for(; first != last; ++first) {
+    if((*first).__verify_exact() == false) {
+      failed++;
+    }
+  }
+  return failed;
+}
+
+__attribute__((noinline)) static unsigned long bulk(Object* first, Object* last) {
+  return CoolChecksum::verify_range(first, last);
+}
+
+// million objects per second, best of 'repetitions'
+static double measure(unsigned long (*verify)(Object*, Object*), Object* objects, unsigned long count,
+                      unsigned int repetitions) {
+  double best = 0;
+  // at least ~4M objects per repetition, for small arrays, too
+  const unsigned long rounds = (count < (1ul << 22)) ? ((1ul << 22) / count) : 1;
+  for(unsigned int r = 0; r < repetitions; r++) {
+    const double start = now();
+    for(unsigned long i = 0; i < rounds; i++) {
+      if(verify(objects, objects + count) != 0) {
+        fprintf(stderr, "verify_range: uncorrectable objects (no bit flips injected)\n");
+        exit(1);
+      }
+    }
+    const double rate = (rounds * count) / (now() - start) / 1e6;
+    best = (rate > best) ? rate : best;
+  }
+  return best;
+}
+
+int main(int argc, char** argv) {
+  const unsigned long max_count = (argc > 1) ? atol(argv[1]) : (1ul << 22);
+  const unsigned int repetitions = (argc > 2) ? atoi(argv[2]) : 5;
+
+  const Object probe;
+  printf("objects of %u bytes, checksum at offset %u\n", (unsigned) sizeof(Object),
+         (unsigned) ((const char*) probe.__chksum_address() - (const char*) &probe));
+  printf("%10s %10s %14s %14s %14s   [M objects per second]\n",
+         "objects", "KiB", "per element", "inlined", "verify_range");
+
+  for(unsigned long count = 1024; count <= max_count; count *= 4) {
+    Object* objects = new Object[count];
+    const double a = measure(per_element, objects, count, repetitions);
+    const double b = measure(inlined, objects, count, repetitions);
+    const double c = measure(bulk, objects, count, repetitions);
+    printf("%10lu %10lu %14.1f %14.1f %14.1f\n", count, (count * sizeof(Object)) / 1024, a, b, c);
+    delete[] objects;
+  }
+  return 0;
+}
@@ -1,5 +1,7 @@
 #include <string.h>
+#include <pthread.h>
 #include <iostream>
+#include "GOP/Scrubber.h"
 using namespace std;
 
 class Rectangle {
@@ -55,6 +57,60 @@ int Circle::instances = 0;
 Circle Circle::single;
 char Circle::name[] = {'C', 'i', 'r', 'l', 'e', '\0'};
 
+class Label {
+private:
+  long int id;
+
+public:
+  Label(long int id) : id(id) {}
+
+  void print() const { cout << "Label: " << id << endl; }
+
+  static void injectFault(Label& l, long int fault) { memcpy(&l.id, &fault, sizeof(fault)); }
+};
+
+class Sensor {
+private:
+  int value;
+
+public:
+  Sensor(int value) : value(value) {}
+
+  int getValue() const { return value; }
+
+  static void injectFault(Sensor& s, int fault) { memcpy(&s.value, &fault, sizeof(fault)); }
+};
+
+class Pixel {
+private:
+  unsigned char red;
+  unsigned char green;
+  unsigned char blue;
+
+public:
+  Pixel() : red(0), green(0), blue(0) {}
+
+  void setColor(unsigned char red, unsigned char green, unsigned char blue) {
+    this->red = red; this->green = green; this->blue = blue;
+  }
+
+  void print() const { cout << "Pixel: " << (int) red << ", " << (int) green << ", " << (int) blue << endl; }
+
+  static void injectFault(Pixel& p, unsigned char fault) { memcpy(&p.green, &fault, sizeof(fault)); }
+};
+
+// data leaves the process here: the protected arguments are verified before
+void send(const Rectangle& r) { cout << "send: " << sizeof(r) << " bytes" << endl; }
+
+void* readSensor(void* arg) {
+  const Sensor* s = static_cast<const Sensor*>(arg);
+  long int sum = 0;
+  for(int i = 0; i < 1000; i++) {
+    sum += s->getValue();
+  }
+  return (void*) sum;
+}
+
 
 int main() {
   Rectangle r;
@@ -78,6 +134,36 @@ int main() {
   memset(&Circle::name[3], 0, sizeof(Circle::name[3])); // 'l' -> 0
   Circle::print_single();
 
+  Circle c; // instances: 1 -> 2 (incremental update of the static checksum)
+  c.print();
+
+  Label l(42);
+  Label::injectFault(l, 13); // id: 42 -> 13
+  l.print();
+
+  Sensor sensor(3);
+  Sensor::injectFault(sensor, 9); // value: 3 -> 9
+  pthread_t readers[4];
+  for(int i = 0; i < 4; i++) {
+    pthread_create(&readers[i], 0, readSensor, &sensor);
+  }
+  long int sum = 0;
+  for(int i = 0; i < 4; i++) {
+    void* result;
+    pthread_join(readers[i], &result);
+    sum += (long int) result;
+  }
+  cout << "Sensor: " << sum << " (4 readers)" << endl;
+
+  Pixel pixels[4];
+  pixels[2].setColor(1, 2, 3);
+  Pixel::injectFault(pixels[2], 7); // green: 2 -> 7
+  CoolChecksum::Scrubber::pass(); // corrected while idle
+  pixels[2].print();
+
+  Rectangle::injectFault(r3, 7); // height: 3 -> 7
+  send(r3);
+
   // nullify complete object (no recovery possible; check on program exit)
   memset(&Circle::single, 0, sizeof(Circle::single));
 